@@ -0,0 +1,60 @@
+#include "../Common/FrameArena.hpp"
+
+#ifdef FORTRESS_COUNT_ALLOCATIONS
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+// the array, nothrow and sized forms of the CRT fall back to these, the aligned ones are replaced separately.
+namespace
+{
+	template <typename Allocate>
+	void* allocate_or_throw(const Allocate& allocate)
+	{
+		Fortress::FrameArena::count_heap_allocation();
+
+		while (true)
+		{
+			if (void* ptr = allocate())
+			{
+				return ptr;
+			}
+
+			const std::new_handler handler = std::get_new_handler();
+
+			if (!handler)
+			{
+				throw std::bad_alloc();
+			}
+
+			handler();
+		}
+	}
+}
+
+void* operator new(const size_t size)
+{
+	return allocate_or_throw([size]()
+	{
+		return std::malloc(size == 0 ? 1 : size);
+	});
+}
+
+void* operator new(const size_t size, const std::align_val_t alignment)
+{
+	return allocate_or_throw([size, alignment]()
+	{
+		return _aligned_malloc(size == 0 ? 1 : size, static_cast<size_t>(alignment));
+	});
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+	_aligned_free(ptr);
+}
+#endif
@@ -1,7 +1,10 @@
 #pragma once
 #include "NutshellProjectile.hpp"
+#include "../Common/BattleScene.h"
 #include "../Common/character.hpp"
+#include "../Common/debug.hpp"
 #include "../Common/item.hpp"
+#include "ShotSimulator.hpp"
 
 namespace Fortress::Network::Client::Object
 {
@@ -11,6 +14,7 @@ namespace Fortress::Network::Client::Object
 		ClientCharacter() = delete;
 
 		void update() override;
+		void render() override;
 
 	private:
 		void send_move() const;
@@ -26,6 +30,7 @@ namespace Fortress::Network::Client::Object
 
 		void update_local_player() const;
 		void update_non_local_player();
+		void render_aim_guide() const;
 
 		bool has_state_changed() const;
 
@@ -58,6 +63,112 @@ namespace Fortress::Network::Client::Object
 		update_non_local_player();
 	}
 
+	inline void ClientCharacter::render()
+	{
+		character::render();
+		render_aim_guide();
+	}
+
+	inline void ClientCharacter::render_aim_guide() const
+	{
+		constexpr int guide_dots = 24;
+
+		if(!is_active() || !is_localplayer() || get_state() != eCharacterState::Firing)
+		{
+			return;
+		}
+
+		const auto scene = std::dynamic_pointer_cast<Scene::BattleScene>(Scene::SceneManager::get_active_scene().lock());
+
+		if(!scene)
+		{
+			return;
+		}
+
+		const auto camera = scene->get_camera().lock();
+		const auto& grounds = scene->get_registry<Fortress::Object::Ground>();
+		const auto predictor = predict_fire(
+			Fortress::Object::Property::projectile_speed_getter(
+				get_short_name(), get_projectile_type() == eProjectileType::Sub ? L"sub" : L"main"),
+			Fortress::Object::Property::projectile_hitbox_getter(),
+			get_charged_power(),
+			static_cast<float>(scene->get_round_status().lock()->get_wind_acceleration()));
+
+		GlobalPosition hit{};
+		// a shot that hits nothing is drawn until it falls below the map.
+		float hit_time = ObjectBase::trajectory_max_time;
+		predictor.get_time_to_y(scene->get_map_size().get_y(), hit_time);
+		hit_time = (std::min)(hit_time, ObjectBase::trajectory_max_time);
+
+		const bool ground_hit = predictor.find_first_hit([&grounds](const GlobalPosition& from, const GlobalPosition& to)
+		{
+			GlobalPosition nearest = Math::vector_inf;
+
+			for(const auto& ptr : grounds)
+			{
+				if(const auto ground = ptr.lock(); ground && ground->is_active())
+				{
+					const auto candidate = ground->safe_ray_cast_global(from, to);
+
+					if(candidate != Math::vector_inf &&
+						(nearest == Math::vector_inf || (candidate - from).magnitude() < (nearest - from).magnitude()))
+					{
+						nearest = candidate;
+					}
+				}
+			}
+
+			return nearest;
+		}, hit, hit_time, hit_time);
+
+		// same shot against the characters too, for the ones in the splash.
+		const auto shot = Fortress::Object::ShotSimulator::simulate(
+			*scene, {{this, get_movement_pitch_radian(), get_charged_power(), get_projectile_type()}}, hit_time)[0];
+
+#ifdef _DEBUG
+		if(ground_hit && shot.hit && shot.character.expired() &&
+			(shot.impact - hit).magnitude() > Fortress::Object::Property::projectile_hitbox_getter().magnitude())
+		{
+			Debug::Log(L"Aim guide and the shot simulation disagree on the impact");
+		}
+#endif
+
+		const auto handle = EngineHandle::get_handle().lock();
+		const HDC hdc = handle->get_buffer_dc();
+		const auto width = static_cast<float>(handle->get_window_width());
+		const auto height = static_cast<float>(handle->get_actual_max_y());
+
+		const HBRUSH brush = CreateSolidBrush(RGB(255, 255, 255));
+		const HBRUSH previous = static_cast<HBRUSH>(SelectObject(hdc, brush));
+
+		for(int i = 1; i <= guide_dots; ++i)
+		{
+			const auto point = camera->get_relative_point(predictor.get_position(hit_time * i / guide_dots));
+
+			// the part above or beside the screen is not drawn.
+			if(point.get_x() < 0.0f || point.get_x() > width || point.get_y() < 0.0f || point.get_y() > height)
+			{
+				continue;
+			}
+
+			Ellipse(hdc, point.get_x() - 2, point.get_y() - 2, point.get_x() + 3, point.get_y() + 3);
+		}
+
+		// marks above the characters that the shot would splash.
+		for(const auto& target : shot.splashed)
+		{
+			if(const auto ch = target.ptr.lock())
+			{
+				const auto point = camera->get_relative_point(ch->get_top() - Math::Vector2{0.0f, 10.0f});
+
+				Ellipse(hdc, point.get_x() - 4, point.get_y() - 4, point.get_x() + 5, point.get_y() + 5);
+			}
+		}
+
+		SelectObject(hdc, previous);
+		DeleteObject(brush);
+	}
+
 	inline void ClientCharacter::send_move() const
 	{
 		EngineHandle::get_messenger()->send_move_signal(get_position(), get_offset());
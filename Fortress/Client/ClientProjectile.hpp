@@ -85,7 +85,7 @@ namespace Fortress::Network::Client::Object
 		EngineHandle::get_messenger()->send_message<ProjectileFireMsg>(
 			eMessageType::ProjectileFire, ProjectileFireMsg
 			{{{}, eObjectType::Projectile, get_center(), get_offset()},
-			get_id(), get_type()});
+			get_id(), get_type(), get_velocity(), get_speed()});
 	}
 
 	inline void ClientProjectile::update_local_player() const
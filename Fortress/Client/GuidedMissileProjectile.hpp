@@ -65,12 +65,12 @@ namespace Fortress::Object
 		if(const auto scene_ptr = Scene::SceneManager::get_active_scene().lock())
 		{
 			// @todo: if radius is big enough to contains shooter itself then missile is moving back and forth.
-			const auto characters = scene_ptr->is_in_range<ObjectBase::character>(
-				detection_point, 100.0f);
+			Abstract::NearestBuffer<ObjectBase::character, 1> characters;
+			scene_ptr->is_in_range(detection_point, 100.0f, characters);
 
 			if (!characters.empty())
 			{
-				if(const auto nearest = characters.front().lock())
+				if(const auto nearest = characters[0].ptr.lock())
 				{
 					if(nearest.get() != get_origin())
 					{
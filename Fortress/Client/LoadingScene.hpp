@@ -5,6 +5,7 @@
 
 #include "../Common/ImageWrapper.hpp"
 #include "../Common/resourceManager.hpp"
+#include "../Common/PhysicsStore.hpp"
 #include "../Common/scene.hpp"
 #include "../Common/sceneManager.hpp"
 #include "../Common/sound.hpp"
@@ -82,6 +83,7 @@ namespace Fortress::Scene
 		if(EngineHandle::get_messenger()->check_game_start(gsm) || 
 			gsm.type == Network::eMessageType::GameStart)
 		{
+			Abstract::PhysicsStore::set_fixed_point(gsm.fixed_point);
 			SceneManager::SetActive<MapName>();
 			load_finished = false;
 			handshake_finished = false;
@@ -0,0 +1,469 @@
+#pragma once
+#ifndef SHOTSIMULATOR_HPP
+#define SHOTSIMULATOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <execution>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+#include "CharacterProperties.hpp"
+#include "../Common/BattleScene.h"
+#include "../Common/projectile.hpp"
+#include "../Common/TrajectoryPredictor.hpp"
+
+namespace Fortress::Object
+{
+	// shots in a batch are stepped together, the batches run in parallel.
+	constexpr size_t shot_batch_size = 64;
+	constexpr float shot_simulation_tick = 1.0f / 60.0f;
+
+	struct ShotRequest
+	{
+		const ObjectBase::character* shooter;
+		// radian, same as the movement pitch of the shooter.
+		float pitch;
+		float charged;
+		eProjectileType type;
+	};
+
+	struct ShotResult
+	{
+		// false if the shot left the map or is still flying at the max time.
+		bool hit = false;
+		GlobalPosition impact{};
+		float time = 0.0f;
+		// expired if the ground is hit.
+		CharacterPointer character{};
+		// characters in the radius of the impact, nearest first, same as the splash of the projectile.
+		Abstract::NearestBuffer<ObjectBase::character, ObjectBase::splash_max_characters> splashed{};
+	};
+
+	/**
+	 * \brief Flies the candidate shots over the terrain and the characters of the scene without creating the
+	 * projectiles. the positions are taken from the closed form of the flight per tick, and the chord between the
+	 * ticks is tested against the characters and the ground like the sweep of the projectile. the characters around
+	 * the impact are collected by the radius of the projectile like its hit.
+	 *
+	 * the grounds are read without the lock same as the aim guide, so this should be called from the update.
+	 */
+	class ShotSimulator
+	{
+	public:
+		static std::vector<ShotResult> simulate(
+			Scene::BattleScene& scene,
+			const std::vector<ShotRequest>& shots,
+			const float max_time = ObjectBase::trajectory_max_time);
+
+	private:
+		struct Target
+		{
+			CharacterPointer ptr;
+			const ObjectBase::character* key;
+			float left;
+			float top;
+			float right;
+			float bottom;
+		};
+
+		struct World
+		{
+			std::vector<std::shared_ptr<Ground>> grounds;
+			std::vector<Target> targets;
+			float wind;
+			float max_y;
+		};
+
+		struct Batch
+		{
+			alignas(16) std::array<float, shot_batch_size> origin_x;
+			alignas(16) std::array<float, shot_batch_size> origin_y;
+			alignas(16) std::array<float, shot_batch_size> velocity_x;
+			alignas(16) std::array<float, shot_batch_size> velocity_y;
+			alignas(16) std::array<float, shot_batch_size> acceleration_x;
+			alignas(16) std::array<float, shot_batch_size> acceleration_y;
+			alignas(16) std::array<float, shot_batch_size> x;
+			alignas(16) std::array<float, shot_batch_size> y;
+			std::array<bool, shot_batch_size> flying;
+		};
+
+		static void load_batch(
+			const World& world, const ShotRequest* shots, const size_t count, Batch& batch);
+		static void simulate_batch(
+			const World& world, const ShotRequest* shots, const size_t count, ShotResult* results, const float max_time);
+		// positions of all lanes at the time.
+		static void advance(Batch& batch, const float time);
+		static bool cast(
+			const World& world,
+			const ShotRequest& shot,
+			const GlobalPosition& from,
+			const GlobalPosition& to,
+			GlobalPosition& hit,
+			float& ratio,
+			CharacterPointer& character);
+		static void collect_splash(
+			const World& world, const ShotRequest& shot, const GlobalPosition& impact, ShotResult& result);
+		// entering ratio of the segment into the box, infinity if it misses.
+		static float intersect(const Target& target, const GlobalPosition& from, const GlobalPosition& to);
+	};
+
+	inline std::vector<ShotResult> ShotSimulator::simulate(
+		Scene::BattleScene& scene,
+		const std::vector<ShotRequest>& shots,
+		const float max_time)
+	{
+		std::vector<ShotResult> results(shots.size());
+
+		if(shots.empty())
+		{
+			return results;
+		}
+
+		World world{};
+		const Math::Vector2 half_hitbox = Property::projectile_hitbox_getter() / 2;
+
+		world.wind = static_cast<float>(scene.get_round_status().lock()->get_wind_acceleration());
+		world.max_y = scene.get_map_size().get_y();
+
+		for(const auto& ptr : scene.get_grounds())
+		{
+			if(const auto ground = ptr.lock(); ground && ground->is_active())
+			{
+				world.max_y = (std::max)(world.max_y, ground->get_bottom_right().get_y());
+				world.grounds.push_back(ground);
+			}
+		}
+
+		// boxes are fattened by the projectile, so the chord of the center is enough.
+		for(const auto& ptr : scene.get_characters())
+		{
+			const auto ch = ptr.lock();
+
+			if(!ch || !ch->is_active() ||
+				ch->get_state() == eCharacterState::Dead || ch->get_state() == eCharacterState::Death)
+			{
+				continue;
+			}
+
+			const Math::Vector2 top_left = ch->get_top_left() - half_hitbox;
+			const Math::Vector2 bottom_right = ch->get_bottom_right() + half_hitbox;
+
+			world.targets.push_back(
+				{
+					ch,
+					ch.get(),
+					top_left.get_x(),
+					top_left.get_y(),
+					bottom_right.get_x(),
+					bottom_right.get_y()
+				});
+		}
+
+		std::vector<size_t> batches((shots.size() + shot_batch_size - 1) / shot_batch_size);
+		std::iota(batches.begin(), batches.end(), 0);
+
+		std::for_each(
+			std::execution::par,
+			batches.begin(),
+			batches.end(),
+			[&](const size_t batch)
+			{
+				const size_t begin = batch * shot_batch_size;
+				const size_t count = (std::min)(shot_batch_size, shots.size() - begin);
+
+				simulate_batch(world, shots.data() + begin, count, results.data() + begin, max_time);
+			});
+
+		return results;
+	}
+
+	inline void ShotSimulator::load_batch(
+		const World& world, const ShotRequest* shots, const size_t count, Batch& batch)
+	{
+		batch.origin_x.fill(0.0f);
+		batch.origin_y.fill(0.0f);
+		batch.velocity_x.fill(0.0f);
+		batch.velocity_y.fill(0.0f);
+		batch.acceleration_x.fill(0.0f);
+		batch.acceleration_y.fill(0.0f);
+		batch.flying.fill(false);
+
+		for(size_t i = 0; i < count; ++i)
+		{
+			const ShotRequest& shot = shots[i];
+
+			if(!shot.shooter)
+			{
+				continue;
+			}
+
+			const std::wstring type = shot.type == eProjectileType::Sub ? L"sub" : L"main";
+			// same as the projectile::fire, the acceleration of the projectiles is zero.
+			const ObjectBase::TrajectoryPredictor predictor(
+				shot.shooter->get_fire_position(Property::projectile_hitbox_getter(), shot.pitch),
+				shot.shooter->get_fire_angle(shot.pitch),
+				Property::projectile_speed_getter(shot.shooter->get_short_name(), type) * shot.charged,
+				{},
+				world.wind);
+
+			const GlobalPosition origin = predictor.get_position(0.0f);
+			const Math::Vector2 velocity = predictor.get_velocity(0.0f);
+			// velocity changes by the acceleration per second.
+			const Math::Vector2 acceleration = predictor.get_velocity(1.0f) - velocity;
+
+			batch.origin_x[i] = origin.get_x();
+			batch.origin_y[i] = origin.get_y();
+			batch.velocity_x[i] = velocity.get_x();
+			batch.velocity_y[i] = velocity.get_y();
+			batch.acceleration_x[i] = acceleration.get_x();
+			batch.acceleration_y[i] = acceleration.get_y();
+			batch.flying[i] = true;
+		}
+	}
+
+	inline void ShotSimulator::simulate_batch(
+		const World& world, const ShotRequest* shots, const size_t count, ShotResult* results, const float max_time)
+	{
+		Batch batch;
+		load_batch(world, shots, count, batch);
+		advance(batch, 0.0f);
+
+		auto flying = static_cast<size_t>(std::count(batch.flying.begin(), batch.flying.begin() + count, true));
+		float time = 0.0f;
+
+		while(flying > 0 && time < max_time)
+		{
+			const float next_time = (std::min)(time + shot_simulation_tick, max_time);
+			const std::array<float, shot_batch_size> previous_x = batch.x;
+			const std::array<float, shot_batch_size> previous_y = batch.y;
+
+			advance(batch, next_time);
+
+			for(size_t i = 0; i < count; ++i)
+			{
+				if(!batch.flying[i])
+				{
+					continue;
+				}
+
+				const GlobalPosition from{previous_x[i], previous_y[i]};
+				const GlobalPosition to{batch.x[i], batch.y[i]};
+				GlobalPosition hit{};
+				float ratio = 0.0f;
+
+				if(cast(world, shots[i], from, to, hit, ratio, results[i].character))
+				{
+					results[i].hit = true;
+					results[i].impact = hit;
+					results[i].time = time + (next_time - time) * ratio;
+					collect_splash(world, shots[i], hit, results[i]);
+					batch.flying[i] = false;
+					--flying;
+				}
+				else if(to.get_y() > world.max_y)
+				{
+					results[i].impact = to;
+					results[i].time = next_time;
+					batch.flying[i] = false;
+					--flying;
+				}
+			}
+
+			time = next_time;
+		}
+
+		for(size_t i = 0; i < count; ++i)
+		{
+			if(batch.flying[i])
+			{
+				results[i].impact = {batch.x[i], batch.y[i]};
+				results[i].time = time;
+			}
+		}
+	}
+
+	inline void ShotSimulator::advance(Batch& batch, const float time)
+	{
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		const __m128 t = _mm_set1_ps(time);
+		const __m128 half_t2 = _mm_set1_ps(0.5f * time * time);
+
+		for(size_t i = 0; i < shot_batch_size; i += 4)
+		{
+			const __m128 x = _mm_add_ps(
+				_mm_add_ps(_mm_load_ps(&batch.origin_x[i]), _mm_mul_ps(_mm_load_ps(&batch.velocity_x[i]), t)),
+				_mm_mul_ps(_mm_load_ps(&batch.acceleration_x[i]), half_t2));
+			const __m128 y = _mm_add_ps(
+				_mm_add_ps(_mm_load_ps(&batch.origin_y[i]), _mm_mul_ps(_mm_load_ps(&batch.velocity_y[i]), t)),
+				_mm_mul_ps(_mm_load_ps(&batch.acceleration_y[i]), half_t2));
+
+			_mm_store_ps(&batch.x[i], x);
+			_mm_store_ps(&batch.y[i], y);
+		}
+#else
+		const float half_t2 = 0.5f * time * time;
+
+		for(size_t i = 0; i < shot_batch_size; ++i)
+		{
+			batch.x[i] = batch.origin_x[i] + batch.velocity_x[i] * time + batch.acceleration_x[i] * half_t2;
+			batch.y[i] = batch.origin_y[i] + batch.velocity_y[i] * time + batch.acceleration_y[i] * half_t2;
+		}
+#endif
+	}
+
+	inline bool ShotSimulator::cast(
+		const World& world,
+		const ShotRequest& shot,
+		const GlobalPosition& from,
+		const GlobalPosition& to,
+		GlobalPosition& hit,
+		float& ratio,
+		CharacterPointer& character)
+	{
+		const float length = (to - from).magnitude();
+		float nearest = std::numeric_limits<float>::infinity();
+
+		for(const Target& target : world.targets)
+		{
+			// shot is launched from the inside of the fattened box of the shooter, it counts after leaving it.
+			if(target.key == shot.shooter &&
+				from.get_x() >= target.left && from.get_x() <= target.right &&
+				from.get_y() >= target.top && from.get_y() <= target.bottom)
+			{
+				continue;
+			}
+
+			if(const float candidate = intersect(target, from, to); candidate < nearest)
+			{
+				nearest = candidate;
+				character = target.ptr;
+			}
+		}
+
+		for(const auto& ground : world.grounds)
+		{
+			const GlobalPosition candidate = ground->safe_ray_cast_global(from, to);
+
+			if(candidate == Math::vector_inf)
+			{
+				continue;
+			}
+
+			if(const float candidate_ratio = length > 0.0f ? (candidate - from).magnitude() / length : 0.0f;
+				candidate_ratio < nearest)
+			{
+				nearest = candidate_ratio;
+				character.reset();
+			}
+		}
+
+		if(nearest == std::numeric_limits<float>::infinity())
+		{
+			return false;
+		}
+
+		ratio = nearest;
+		hit = from + (to - from) * nearest;
+		return true;
+	}
+
+	inline void ShotSimulator::collect_splash(
+		const World& world, const ShotRequest& shot, const GlobalPosition& impact, ShotResult& result)
+	{
+		const float radius = Property::projectile_radius_getter(
+			shot.shooter->get_short_name(), shot.type == eProjectileType::Sub ? L"sub" : L"main");
+		const Math::Vector2 half_hitbox = Property::projectile_hitbox_getter() / 2;
+		const float half_x = half_hitbox.get_x();
+		const float half_y = half_hitbox.get_y();
+		// hit points of the projectile at the impact, same as the ones of projectile::hit.
+		const std::array<Math::Vector2, 9> hit_points =
+		{
+			impact,
+			impact + Math::Vector2{0.0f, -half_y}, impact + Math::Vector2{0.0f, half_y},
+			impact + Math::Vector2{-half_x, 0.0f}, impact + Math::Vector2{half_x, 0.0f},
+			impact + Math::Vector2{-half_x, -half_y}, impact + Math::Vector2{half_x, -half_y},
+			impact + Math::Vector2{-half_x, half_y}, impact + Math::Vector2{half_x, half_y}
+		};
+
+		for(const Target& target : world.targets)
+		{
+			float nearest = std::numeric_limits<float>::infinity();
+			Math::Vector2 nearest_point{};
+
+			for(const auto& point : hit_points)
+			{
+				const Math::Vector2 candidate = target.key->get_nearest_point(point);
+				const float distance = (point - candidate).magnitude();
+
+				if(distance < nearest)
+				{
+					nearest = distance;
+					nearest_point = candidate;
+				}
+			}
+
+			if(nearest > radius)
+			{
+				continue;
+			}
+
+			if(const auto ch = target.ptr.lock())
+			{
+				result.splashed.insert(ch, nearest, nearest_point);
+			}
+		}
+	}
+
+	inline float ShotSimulator::intersect(const Target& target, const GlobalPosition& from, const GlobalPosition& to)
+	{
+		const float delta[2] = {to.get_x() - from.get_x(), to.get_y() - from.get_y()};
+		const float origin[2] = {from.get_x(), from.get_y()};
+		const float minimum[2] = {target.left, target.top};
+		const float maximum[2] = {target.right, target.bottom};
+
+		float t_enter = 0.0f;
+		float t_exit = 1.0f;
+
+		for(int axis = 0; axis < 2; ++axis)
+		{
+			if(std::fabs(delta[axis]) <= Math::epsilon)
+			{
+				if(origin[axis] < minimum[axis] || origin[axis] > maximum[axis])
+				{
+					return std::numeric_limits<float>::infinity();
+				}
+
+				continue;
+			}
+
+			float t0 = (minimum[axis] - origin[axis]) / delta[axis];
+			float t1 = (maximum[axis] - origin[axis]) / delta[axis];
+
+			if(t0 > t1)
+			{
+				std::swap(t0, t1);
+			}
+
+			t_enter = (std::max)(t_enter, t0);
+			t_exit = (std::min)(t_exit, t1);
+
+			if(t_enter > t_exit)
+			{
+				return std::numeric_limits<float>::infinity();
+			}
+		}
+
+		return t_enter;
+	}
+}
+
+#endif // SHOTSIMULATOR_HPP
@@ -12,6 +12,7 @@
 #include "../Common/deltatime.hpp"
 #include "../Common/BattleScene.h"
 #include "../Common/debug.hpp"
+#include "../Common/FrameArena.hpp"
 #include "../Common/sceneManager.hpp"
 #include "../Common/scene.hpp"
 #include "../Common/SoundManager.hpp"
@@ -47,6 +48,14 @@ namespace Fortress
 			return;
 		}
 
+		// transient allocations of the previous frame are drawn already.
+		FrameArena::reset();
+
+#ifdef FORTRESS_COUNT_ALLOCATIONS
+		// zero in the steady state, the scene changes and the loading are expected to allocate.
+		Debug::Log(L"Heap allocations: %zu", FrameArena::get_last_frame_heap_allocations());
+#endif
+
 		/*Debug::draw_line(
 			{static_cast<float>(WinAPIHandles::get_window_width() / 2), 0}, 
 			{static_cast<float>(WinAPIHandles::get_window_width() / 2), static_cast<float>(WinAPIHandles::get_actual_max_y())});
@@ -56,9 +65,17 @@ namespace Fortress
 			{static_cast<float>(WinAPIHandles::get_window_width()), static_cast<float>(WinAPIHandles::get_actual_max_y() / 2)})*/;
 
 		DeltaTime::update();
+		// sampled once per frame, so the render sees the key edges of this frame only.
 		Input::update();
-		TimerManager::update();
-		Scene::SceneManager::update();
+
+		// simulation runs in the fixed tick, render interpolates the remaining.
+		while (DeltaTime::step())
+		{
+			Input::begin_tick();
+			TimerManager::update();
+			Scene::SceneManager::update();
+			Input::end_tick();
+		}
 	}
 
 	void Application::render()
@@ -11,6 +11,7 @@
 #include "message.hpp"
 #include "objectManager.hpp"
 #include "Radar.h"
+#include "TerrainSync.h"
 
 #undef min
 #undef max
@@ -21,6 +22,7 @@ namespace Fortress::Scene
 		scene(L"Battle Scene " + name),
 		m_map_size({}),
 		m_round(std::make_shared<Round>()), // lazy-initialization
+		m_previous_round_state(eRoundState::Start),
 		m_game_init(game_init)
 	{
 	}
@@ -44,16 +46,19 @@ namespace Fortress::Scene
 
 		m_map_size = evaluate_map_size();
 		m_radar = std::make_unique<Radar>(m_map_size);
+		m_terrain_sync = std::make_unique<TerrainSync>(m_grounds);
 
 		for (const auto& [pid, ch] : m_characters)
 		{
 			add_game_object(Abstract::LayerType::Character, ch);
 			ch.lock()->set_disabled();
+			ch.lock()->prewarm_projectiles();
 		}
 
 		for (const auto& gr : m_grounds)
 		{
 			add_game_object(Abstract::LayerType::Ground, gr);
+			gr.lock()->set_distance_field_enabled(true);
 			gr.lock()->set_disabled();
 		}
 
@@ -65,8 +70,36 @@ namespace Fortress::Scene
 	void BattleScene::update()
 	{
 		scene::update();
+
+		// explosions of this frame are carved together.
+		for (const auto& gr : m_grounds)
+		{
+			if (const auto ground = gr.lock())
+			{
+				ground->safe_apply_craters();
+			}
+		}
+
 		m_round->update();
 		m_radar->update();
+
+		// shooter of the turn is the authority of the terrain, the others check against it after the turn.
+		const auto round_state = m_round->get_current_status();
+
+		if (round_state == eRoundState::NextTurn && m_previous_round_state != eRoundState::NextTurn)
+		{
+			const auto shooter = m_round->get_current_player().lock();
+
+			m_terrain_sync->next_turn();
+
+			if (shooter && shooter != m_self.lock())
+			{
+				m_terrain_sync->request(shooter->get_player_id());
+			}
+		}
+
+		m_terrain_sync->update();
+		m_previous_round_state = round_state;
 	}
 
 	Math::Vector2 operator/(float lhs, const Math::Vector2& rhs)
@@ -10,6 +10,7 @@
 #include "sound.hpp"
 #include "scene.hpp"
 #include "Radar.h"
+#include "TerrainSync.h"
 
 namespace Fortress::Scene
 {
@@ -54,6 +55,8 @@ namespace Fortress::Scene
 		std::weak_ptr<ImageWrapper> m_background;
 		std::shared_ptr<Round> m_round;
 		std::unique_ptr<Radar> m_radar;
+		std::unique_ptr<TerrainSync> m_terrain_sync;
+		eRoundState m_previous_round_state;
 		Network::GameInitMsg m_game_init;
 	};
 }
@@ -598,9 +598,10 @@ namespace Fortress::Controller
 		const auto scene = Scene::SceneManager::get_active_scene().lock();
 		const auto projectiles = get_projectiles();
 
+		// projectiles are pooled by the character, only detached from the scene.
 		for(const auto& prj : projectiles)
 		{
-			scene->remove_game_object(Abstract::LayerType::Projectile, prj);
+			scene->detach_game_object(Abstract::LayerType::Projectile, prj);
 		}
 
 		m_active_projectiles.clear();
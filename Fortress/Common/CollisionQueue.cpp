@@ -0,0 +1,125 @@
+#include "pch.h"
+#include "CollisionQueue.hpp"
+
+#include <algorithm>
+
+#include "rigidBody.hpp"
+
+namespace Fortress::Abstract
+{
+	void CollisionQueue::add_body(const std::shared_ptr<rigidBody>& body)
+	{
+		m_bodies[get_index(body)].updated = true;
+	}
+
+	int CollisionQueue::get_index(const std::shared_ptr<rigidBody>& body)
+	{
+		const int index = body->m_collision_index;
+
+		// index can be left from the queue of the other scene.
+		if(index >= 0 && index < static_cast<int>(m_bodies.size()) && m_bodies[index].key == body.get())
+		{
+			return index;
+		}
+
+		const std::type_index type(typeid(*body));
+		auto handler = std::find(m_handlers.begin(), m_handlers.end(), type);
+
+		if(handler == m_handlers.end())
+		{
+			handler = m_handlers.insert(m_handlers.end(), type);
+		}
+
+		body->m_collision_index = static_cast<int>(m_bodies.size());
+		m_bodies.push_back({body, body.get(), static_cast<int>(handler - m_handlers.begin()), false, false, false});
+
+		return body->m_collision_index;
+	}
+
+	void CollisionQueue::push(
+		const std::shared_ptr<rigidBody>& body,
+		const std::shared_ptr<rigidBody>& other,
+		const CollisionCode code,
+		const GlobalPosition& collision_point)
+	{
+		const int body_index = get_index(body);
+		const int other_index = get_index(other);
+
+		m_bodies[body_index].collided = true;
+		m_events.push_back(
+			{
+				m_bodies[body_index].handler,
+				body_index,
+				other_index,
+				code,
+				collision_point.get_x(),
+				collision_point.get_y()
+			});
+	}
+
+	void CollisionQueue::exit(const std::shared_ptr<rigidBody>& body)
+	{
+		m_bodies[get_index(body)].exited = true;
+	}
+
+	void CollisionQueue::dispatch()
+	{
+		// same type of the handlers are called together, in the order of the update within the type.
+		std::stable_sort(m_events.begin(), m_events.end(), [](const CollisionEvent& left, const CollisionEvent& right)
+		{
+			return left.handler < right.handler || 
+				(left.handler == right.handler && 
+					(left.body < right.body || (left.body == right.body && left.other < right.other)));
+		});
+		m_events.erase(
+			std::unique(m_events.begin(), m_events.end(), [](const CollisionEvent& left, const CollisionEvent& right)
+			{
+				return left.body == right.body && left.other == right.other;
+			}),
+			m_events.end());
+
+		for(const CollisionEvent& event : m_events)
+		{
+			const auto body = m_bodies[event.body].ptr.lock();
+			const auto other = m_bodies[event.other].ptr.lock();
+
+			// deactivated by the handlers of this frame.
+			if(!body || !other || !body->is_active() || !other->is_active())
+			{
+				continue;
+			}
+
+			body->on_collision(event.code, {event.x, event.y}, other);
+		}
+
+		for(const Body& entry : m_bodies)
+		{
+			const auto body = entry.ptr.lock();
+
+			if(!body)
+			{
+				continue;
+			}
+
+			body->m_collision_index = -1;
+
+			// the other side of a collision is moved by its own update.
+			if(!entry.updated || !body->is_active())
+			{
+				continue;
+			}
+
+			// still collides with the others.
+			if(entry.exited && !entry.collided)
+			{
+				body->on_nocollison();
+			}
+
+			body->move();
+		}
+
+		m_bodies.clear();
+		m_handlers.clear();
+		m_events.clear();
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+#ifndef COLLISIONQUEUE_HPP
+#define COLLISIONQUEUE_HPP
+
+#include <memory>
+#include <typeindex>
+#include <vector>
+
+#include "common.h"
+
+namespace Fortress::Abstract
+{
+	class rigidBody;
+
+	// bodies are the indices of the queue of this frame.
+	struct CollisionEvent
+	{
+		int handler;
+		int body;
+		int other;
+		CollisionCode code;
+		float x;
+		float y;
+	};
+
+	/**
+	 * \brief Collects the collisions of the narrowphase and dispatches them after every body is tested, so that the
+	 * handlers do not change the world while the others are still testing against it. the events are grouped by the
+	 * type of the receiving body, and the duplicated pairs are dropped.
+	 */
+	class CollisionQueue
+	{
+	public:
+		CollisionQueue() = default;
+		CollisionQueue& operator=(const CollisionQueue& other) = default;
+		CollisionQueue& operator=(CollisionQueue&& other) = default;
+		CollisionQueue(const CollisionQueue& other) = default;
+		CollisionQueue(CollisionQueue&& other) = default;
+		~CollisionQueue() = default;
+
+		// body is moved in the dispatch, even if it has no collision. the other side of a collision is not.
+		void add_body(const std::shared_ptr<rigidBody>& body);
+		void push(
+			const std::shared_ptr<rigidBody>& body,
+			const std::shared_ptr<rigidBody>& other,
+			const CollisionCode code,
+			const GlobalPosition& collision_point);
+		// a collision of the body which is touched in the last test is gone.
+		void exit(const std::shared_ptr<rigidBody>& body);
+		// calls on_collision, on_nocollison and move of the added bodies in the order of the addition, and clears the queue.
+		// on_nocollison is called once, when the last collision of the body is gone.
+		void dispatch();
+
+		const std::vector<CollisionEvent>& get_events() const;
+
+	private:
+		struct Body
+		{
+			std::weak_ptr<rigidBody> ptr;
+			const rigidBody* key;
+			int handler;
+			bool updated;
+			bool collided;
+			bool exited;
+		};
+
+		// index of the body in this frame, which is kept on the body.
+		int get_index(const std::shared_ptr<rigidBody>& body);
+
+		// capacities are kept between the frames.
+		std::vector<Body> m_bodies;
+		// types in the order of the first appearance, there are only a few of them.
+		std::vector<std::type_index> m_handlers;
+		std::vector<CollisionEvent> m_events;
+	};
+
+	inline const std::vector<CollisionEvent>& CollisionQueue::get_events() const
+	{
+		return m_events;
+	}
+}
+
+#endif // COLLISIONQUEUE_HPP
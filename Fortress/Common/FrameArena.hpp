@@ -0,0 +1,85 @@
+#pragma once
+#ifndef FRAMEARENA_HPP
+#define FRAMEARENA_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+
+// heap allocations are counted by the client in the debug build, for checking the steady state of the frames.
+#if defined(_DEBUG) && !defined(FORTRESS_COUNT_ALLOCATIONS)
+#define FORTRESS_COUNT_ALLOCATIONS
+#endif
+
+namespace Fortress
+{
+	/**
+	 * \brief Linear allocator of the transient allocations of a frame. the memory is bumped from the fixed buffer and
+	 * given back at once by the reset at the top of the update, so nothing allocated from the arena should outlive
+	 * the frame. if the buffer is exhausted, the heap is used as the upstream until the next reset.
+	 */
+	class FrameArena final
+	{
+	public:
+		static void reset();
+		static std::pmr::memory_resource* get_resource() noexcept;
+
+		// uninitialized storage of the count of T, T is not destructed by the reset.
+		template <class T>
+		static T* allocate(size_t count);
+
+		// called by the replaced global operator new, zero if FORTRESS_COUNT_ALLOCATIONS is not defined.
+		static void count_heap_allocation() noexcept;
+		// calls of the global operator new in the calling thread since the start.
+		static size_t get_heap_allocations() noexcept;
+		// heap allocations of the thread that resets the arena in the previous frame, zero in the steady state.
+		static size_t get_last_frame_heap_allocations() noexcept;
+
+	private:
+		static constexpr size_t arena_size = 1 << 20;
+
+		alignas(std::max_align_t) inline static std::byte m_buffer[arena_size] = {};
+		inline static std::pmr::monotonic_buffer_resource m_resource{
+			m_buffer, arena_size, std::pmr::new_delete_resource()};
+		inline static size_t m_frame_start = 0;
+		inline static size_t m_last_frame = 0;
+		inline static thread_local size_t m_heap_allocations = 0;
+	};
+
+	inline void FrameArena::reset()
+	{
+		m_last_frame = get_heap_allocations() - m_frame_start;
+		m_resource.release();
+		m_frame_start = get_heap_allocations();
+	}
+
+	inline std::pmr::memory_resource* FrameArena::get_resource() noexcept
+	{
+		return &m_resource;
+	}
+
+	template <class T>
+	T* FrameArena::allocate(const size_t count)
+	{
+		static_assert(std::is_trivially_destructible_v<T>);
+
+		return static_cast<T*>(m_resource.allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	inline void FrameArena::count_heap_allocation() noexcept
+	{
+		++m_heap_allocations;
+	}
+
+	inline size_t FrameArena::get_heap_allocations() noexcept
+	{
+		return m_heap_allocations;
+	}
+
+	inline size_t FrameArena::get_last_frame_heap_allocations() noexcept
+	{
+		return m_last_frame;
+	}
+}
+
+#endif // FRAMEARENA_HPP
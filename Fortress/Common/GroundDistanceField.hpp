@@ -0,0 +1,289 @@
+#pragma once
+#ifndef GROUNDDISTANCEFIELD_HPP
+#define GROUNDDISTANCEFIELD_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "GroundGrid.hpp"
+#include "vector2.hpp"
+
+namespace Fortress::Object
+{
+	// distance is kept only near the surface, farther is clamped to the band.
+	constexpr int ground_distance_band = 16;
+	// stored in 1/4 pixel.
+	constexpr int ground_distance_scale = 4;
+	constexpr int8_t ground_distance_far = ground_distance_band * ground_distance_scale;
+
+	using GroundDistanceData = std::array<int8_t, ground_chunk_size * ground_chunk_size>;
+
+	/**
+	 * \brief A signed distance to the surface of the ground, positive in the empty (destroyed or out of bound)
+	 * space and negative in the solid. chunks of the table which are farther than the band from the surface
+	 * do not hold the data.
+	 */
+	class GroundDistanceField
+	{
+	public:
+		GroundDistanceField() : m_width(0), m_height(0), m_chunk_columns(0)
+		{
+		}
+
+		GroundDistanceField& operator=(const GroundDistanceField& other) = delete;
+		GroundDistanceField& operator=(GroundDistanceField&& other) = default;
+		GroundDistanceField(const GroundDistanceField& other) = delete;
+		GroundDistanceField(GroundDistanceField&& other) = default;
+		~GroundDistanceField() = default;
+
+		void reset(const GroundGrid& grid);
+		// recomputes the distances that can be changed by the writes in the region.
+		void update(const GroundGrid& grid, const RECT& region);
+
+		// in pixel, clamped to the band.
+		float get_distance(const int x, const int y) const;
+		// unit vector toward the empty space, zero if the point is far from the surface.
+		Math::Vector2 get_normal(const int x, const int y) const;
+
+	private:
+		struct Chunk
+		{
+			int8_t uniform = ground_distance_far;
+			std::unique_ptr<GroundDistanceData> data;
+		};
+
+		int8_t get_raw(const int x, const int y) const;
+		void set_raw(const int x, const int y, const int8_t value);
+		void compact(const RECT& region);
+
+		int m_width;
+		int m_height;
+		int m_chunk_columns;
+
+		std::vector<Chunk> m_chunks;
+		// chamfer 3-4 distances to the solid and to the empty, sized to the window of the last crater.
+		std::vector<uint16_t> m_to_solid;
+		std::vector<uint16_t> m_to_empty;
+	};
+
+	inline void GroundDistanceField::reset(const GroundGrid& grid)
+	{
+		m_width = grid.get_width();
+		m_height = grid.get_height();
+		m_chunk_columns = grid.get_chunk_columns();
+
+		m_chunks.clear();
+		m_chunks.resize(static_cast<size_t>(grid.get_chunk_columns()) * grid.get_chunk_rows());
+
+		update(grid, {0, 0, m_width, m_height});
+
+		// window of the full reset covers the map, the craters need far less.
+		m_to_solid.clear();
+		m_to_solid.shrink_to_fit();
+		m_to_empty.clear();
+		m_to_empty.shrink_to_fit();
+	}
+
+	inline void GroundDistanceField::update(const GroundGrid& grid, const RECT& region)
+	{
+		// pixels that can be affected by the change.
+		const int left = (std::max)(static_cast<int>(region.left) - ground_distance_band, 0);
+		const int top = (std::max)(static_cast<int>(region.top) - ground_distance_band, 0);
+		const int right = (std::min)(static_cast<int>(region.right) + ground_distance_band, m_width);
+		const int bottom = (std::min)(static_cast<int>(region.bottom) + ground_distance_band, m_height);
+
+		if(left >= right || top >= bottom)
+		{
+			return;
+		}
+
+		// seeds within the band of the affected pixels, one pixel ring of out of bound is counted as empty.
+		constexpr int margin = ground_distance_band + 1;
+		const int window_left = (std::max)(left - margin, -1);
+		const int window_top = (std::max)(top - margin, -1);
+		const int window_right = (std::min)(right + margin, m_width + 1);
+		const int window_bottom = (std::min)(bottom + margin, m_height + 1);
+		const int width = window_right - window_left;
+		const int height = window_bottom - window_top;
+
+		constexpr uint16_t infinite = 0x7fff;
+		constexpr uint16_t straight = 3;
+		constexpr uint16_t diagonal = 4;
+
+		m_to_solid.resize(static_cast<size_t>(width) * height);
+		m_to_empty.resize(static_cast<size_t>(width) * height);
+
+		for(int y = 0; y < height; ++y)
+		{
+			for(int x = 0; x < width; ++x)
+			{
+				const int gx = window_left + x;
+				const int gy = window_top + y;
+				const bool solid = grid.is_in_bound(gx, gy) && grid.get(gx, gy) == GroundState::NotDestroyed;
+				const size_t i = static_cast<size_t>(y) * width + x;
+
+				m_to_solid[i] = solid ? 0 : infinite;
+				m_to_empty[i] = solid ? infinite : 0;
+			}
+		}
+
+		const auto relax = [&](std::vector<uint16_t>& field, const size_t i, const int x, const int y, const int dx, const int dy, const uint16_t cost)
+		{
+			const int nx = x + dx;
+			const int ny = y + dy;
+
+			if(nx < 0 || nx >= width || ny < 0 || ny >= height)
+			{
+				return;
+			}
+
+			const uint16_t candidate = field[static_cast<size_t>(ny) * width + nx] + cost;
+
+			if(candidate < field[i])
+			{
+				field[i] = candidate;
+			}
+		};
+
+		for(auto* field : {&m_to_solid, &m_to_empty})
+		{
+			// forward pass
+			for(int y = 0; y < height; ++y)
+			{
+				for(int x = 0; x < width; ++x)
+				{
+					const size_t i = static_cast<size_t>(y) * width + x;
+					relax(*field, i, x, y, -1, 0, straight);
+					relax(*field, i, x, y, 0, -1, straight);
+					relax(*field, i, x, y, -1, -1, diagonal);
+					relax(*field, i, x, y, 1, -1, diagonal);
+				}
+			}
+
+			// backward pass
+			for(int y = height - 1; y >= 0; --y)
+			{
+				for(int x = width - 1; x >= 0; --x)
+				{
+					const size_t i = static_cast<size_t>(y) * width + x;
+					relax(*field, i, x, y, 1, 0, straight);
+					relax(*field, i, x, y, 0, 1, straight);
+					relax(*field, i, x, y, 1, 1, diagonal);
+					relax(*field, i, x, y, -1, 1, diagonal);
+				}
+			}
+		}
+
+		for(int y = top; y < bottom; ++y)
+		{
+			for(int x = left; x < right; ++x)
+			{
+				const size_t i = static_cast<size_t>(y - window_top) * width + (x - window_left);
+				const int chamfer = m_to_solid[i] == 0 ? -static_cast<int>(m_to_empty[i]) : m_to_solid[i];
+				// chamfer unit is 1/3 pixel.
+				const int scaled = static_cast<int>(std::lround(chamfer * ground_distance_scale / 3.0f));
+
+				set_raw(x, y, static_cast<int8_t>(std::clamp(scaled, -ground_distance_far, static_cast<int>(ground_distance_far))));
+			}
+		}
+
+		compact({left, top, right, bottom});
+	}
+
+	inline float GroundDistanceField::get_distance(const int x, const int y) const
+	{
+		return static_cast<float>(get_raw(x, y)) / ground_distance_scale;
+	}
+
+	inline Math::Vector2 GroundDistanceField::get_normal(const int x, const int y) const
+	{
+		const float gx = static_cast<float>(get_raw(x + 1, y) - get_raw(x - 1, y));
+		const float gy = static_cast<float>(get_raw(x, y + 1) - get_raw(x, y - 1));
+
+		if(gx == 0.0f && gy == 0.0f)
+		{
+			return Math::zero;
+		}
+
+		return Math::Vector2{gx, gy}.normalized();
+	}
+
+	inline int8_t GroundDistanceField::get_raw(const int x, const int y) const
+	{
+		// out of bound is empty and farther than the band from the table.
+		if(x < 0 || x >= m_width || y < 0 || y >= m_height)
+		{
+			return ground_distance_far;
+		}
+
+		const Chunk& chunk = m_chunks[
+			static_cast<size_t>(y / ground_chunk_size) * m_chunk_columns + x / ground_chunk_size];
+
+		if(!chunk.data)
+		{
+			return chunk.uniform;
+		}
+
+		return (*chunk.data)[(y % ground_chunk_size) * ground_chunk_size + x % ground_chunk_size];
+	}
+
+	inline void GroundDistanceField::set_raw(const int x, const int y, const int8_t value)
+	{
+		Chunk& chunk = m_chunks[
+			static_cast<size_t>(y / ground_chunk_size) * m_chunk_columns + x / ground_chunk_size];
+
+		if(!chunk.data)
+		{
+			if(chunk.uniform == value)
+			{
+				return;
+			}
+
+			chunk.data = std::make_unique<GroundDistanceData>();
+			chunk.data->fill(chunk.uniform);
+		}
+
+		(*chunk.data)[(y % ground_chunk_size) * ground_chunk_size + x % ground_chunk_size] = value;
+	}
+
+	inline void GroundDistanceField::compact(const RECT& region)
+	{
+		for(int cy = region.top / ground_chunk_size; cy <= (region.bottom - 1) / ground_chunk_size; ++cy)
+		{
+			for(int cx = region.left / ground_chunk_size; cx <= (region.right - 1) / ground_chunk_size; ++cx)
+			{
+				Chunk& chunk = m_chunks[static_cast<size_t>(cy) * m_chunk_columns + cx];
+
+				if(!chunk.data)
+				{
+					continue;
+				}
+
+				const int valid_columns = (std::min)(ground_chunk_size, m_width - cx * ground_chunk_size);
+				const int valid_rows = (std::min)(ground_chunk_size, m_height - cy * ground_chunk_size);
+				const int8_t first = (*chunk.data)[0];
+				bool uniform = first == ground_distance_far || first == -ground_distance_far;
+
+				for(int y = 0; y < valid_rows && uniform; ++y)
+				{
+					for(int x = 0; x < valid_columns && uniform; ++x)
+					{
+						uniform = (*chunk.data)[y * ground_chunk_size + x] == first;
+					}
+				}
+
+				if(uniform)
+				{
+					chunk.data.reset();
+					chunk.uniform = first;
+				}
+			}
+		}
+	}
+}
+
+#endif // GROUNDDISTANCEFIELD_HPP
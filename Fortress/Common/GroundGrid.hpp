@@ -0,0 +1,769 @@
+#pragma once
+#ifndef GROUNDGRID_HPP
+#define GROUNDGRID_HPP
+
+#include <windows.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <intrin.h>
+#include <memory>
+#include <vector>
+
+namespace Fortress::Object
+{
+	enum class GroundState
+	{
+		NotDestroyed = static_cast<uint8_t>(0),
+		Outline,
+		Destroyed,
+		OutOfBound,
+	};
+
+	using GroundWord = uint64_t;
+
+	constexpr int ground_bits_per_pixel = 2;
+	constexpr int ground_pixels_per_word = static_cast<int>(sizeof(GroundWord) * 8) / ground_bits_per_pixel;
+	constexpr GroundWord ground_pixel_mask = 0b11;
+	// lower bit of every pixel in a word.
+	constexpr GroundWord ground_lower_bits = 0x5555555555555555ull;
+
+	constexpr int ground_chunk_size = 64;
+	constexpr int ground_chunk_row_words = ground_chunk_size / ground_pixels_per_word;
+	constexpr int ground_chunk_words = ground_chunk_row_words * ground_chunk_size;
+
+	// occupancy summaries are kept per 8x8 block, 64 blocks per chunk.
+	constexpr int ground_block_size = 8;
+	constexpr int ground_chunk_blocks = ground_chunk_size / ground_block_size;
+
+	using GroundChunkData = std::array<GroundWord, ground_chunk_words>;
+
+	/**
+	 * \brief A square tile of the table. if the chunk has no data, every pixel of it is uniform_state.
+	 */
+	struct GroundChunk
+	{
+		GroundState uniform_state = GroundState::NotDestroyed;
+		// shared with the snapshots, copied on the first write after a snapshot is taken.
+		std::shared_ptr<GroundChunkData> data;
+
+		// bit (block_y * 8 + block_x) is set if the block has any solid pixel. blocks out of the table are unset.
+		uint64_t any_solid = ~0ull;
+		// bit is set if every pixel of the block is solid. blocks out of the table are set.
+		uint64_t all_solid = ~0ull;
+
+		bool is_empty() const
+		{
+			return any_solid == 0;
+		}
+
+		bool is_solid() const
+		{
+			return all_solid == ~0ull;
+		}
+
+		bool is_uniform() const
+		{
+			return !data;
+		}
+
+		bool is_uniform(const GroundState& state) const
+		{
+			return !data && uniform_state == state;
+		}
+	};
+
+	/**
+	 * \brief A state of the table at the version. chunks share the data with the table until either of them is written.
+	 */
+	struct GroundSnapshot
+	{
+		uint64_t version = 0;
+		int width = 0;
+		int height = 0;
+		std::vector<GroundChunk> chunks;
+	};
+
+	/**
+	 * \brief A packed destruction table of the ground, split into 64x64 chunks. each pixel takes
+	 * 2 bits (GroundState), 32 pixels per word. fully solid or fully destroyed chunks are kept as
+	 * a flag, and only the mixed chunks hold the pixel data. each chunk also has "any solid" and
+	 * "all solid" summaries of 8x8 blocks, so the queries can skip the open sky and the solid ground
+	 * at the block (8x8) or the chunk (64x64) level.
+	 */
+	class GroundGrid
+	{
+	public:
+		GroundGrid() : m_width(0), m_height(0), m_chunk_columns(0), m_chunk_rows(0), m_version(0)
+		{
+		}
+
+		GroundGrid& operator=(const GroundGrid& other) = delete;
+		GroundGrid& operator=(GroundGrid&& other) = default;
+		GroundGrid(const GroundGrid& other) = delete;
+		GroundGrid(GroundGrid&& other) = default;
+		~GroundGrid() = default;
+
+		void reset(const int width, const int height, const GroundState& state);
+
+		int get_width() const;
+		int get_height() const;
+		int get_words_per_row() const;
+		bool is_in_bound(const int x, const int y) const;
+
+		int get_chunk_columns() const;
+		int get_chunk_rows() const;
+		const GroundChunk& get_chunk(const int chunk_x, const int chunk_y) const;
+		// the area of the chunk that is inside of the table.
+		RECT get_chunk_rect(const int chunk_x, const int chunk_y) const;
+		// releases the data of the chunks in the region if they became uniform, and
+		// recomputes the occupancy summaries of them. should be called after the writes.
+		void refresh(const RECT& region);
+
+		// increases on every reset and refresh.
+		uint64_t get_version() const;
+		// copies the chunk handles only, O(chunks).
+		GroundSnapshot snapshot() const;
+		// puts back the chunks that differ from the snapshot and appends their areas to the changed.
+		// version moves forward as any other write, so a number is never given to two states. returns false
+		// and does nothing if the snapshot is taken from a table of the different size.
+		bool restore(const GroundSnapshot& snapshot, std::vector<RECT>& changed);
+		// replaces the whole chunk, refresh is up to caller.
+		void assign_chunk(const int chunk_x, const int chunk_y, const GroundChunkData& words);
+
+		// solid means NotDestroyed. queries are clipped by the table bound.
+		bool is_block_empty(const int x, const int y) const;
+		bool is_block_solid(const int x, const int y) const;
+		bool is_chunk_empty(const int x, const int y) const;
+		bool is_chunk_solid(const int x, const int y) const;
+		bool is_region_empty(const RECT& region) const;
+		bool is_region_solid(const RECT& region) const;
+
+		// bound check is up to caller.
+		GroundState get(const int x, const int y) const;
+		void set(const int x, const int y, const GroundState& state);
+
+		GroundWord get_word(const int word_x, const int y) const;
+		void set_word(const int word_x, const int y, const GroundWord word);
+
+		// sets [x_begin, x_end) of the row, out of bound part is clipped.
+		void fill_span(const int y, const int x_begin, const int x_end, const GroundState& state);
+		// allocates the chunks that fill_span_atomic of the same span would write into.
+		void prepare_span(const int y, const int x_begin, const int x_end, const GroundState& state);
+		// fill_span with the atomic word writes, the span should be prepared beforehand.
+		// concurrent callers are safe as long as they all write the same state.
+		void fill_span_atomic(const int y, const int x_begin, const int x_end, const GroundState& state);
+		// first x that has the state (or does not have, if match is false), from x_from to x_to
+		// (inclusive, either direction). -1 if not found.
+		int find_in_row(
+			const int y, const int x_from, const int x_to, const GroundState& state, const bool match = true) const;
+
+		static GroundWord fill_pattern(const GroundState& state);
+		static int to_word_x(const int x);
+		static int to_bit_shift(const int x);
+		static GroundWord bit_range_mask(const int bit_begin, const int bit_end);
+		// lower bit of each pixel is set if the pixel has the state.
+		static GroundWord match_state(const GroundWord word, const GroundState& state);
+
+	private:
+		GroundChunk& get_chunk_of(const int x, const int y);
+		const GroundChunk& get_chunk_of(const int x, const int y) const;
+		GroundWord& get_writable_word(const int word_x, const int y);
+		static void materialize(GroundChunk& chunk);
+		// calls visitor(word_x, mask) for each word of the clipped span, except the chunks already in the state.
+		template <typename Visitor>
+		void visit_span(const int y, const int x_begin, const int x_end, const GroundState& state, const Visitor& visitor);
+		uint64_t get_valid_blocks(const int chunk_x, const int chunk_y) const;
+		void update_summary(const int chunk_x, const int chunk_y);
+		// checks the region against the summaries, looks into the pixels only for the partially covered blocks.
+		bool is_region_uniform(const RECT& region, const bool solid) const;
+
+		int m_width;
+		int m_height;
+		int m_chunk_columns;
+		int m_chunk_rows;
+		uint64_t m_version;
+
+		std::vector<GroundChunk> m_chunks;
+	};
+
+	inline void GroundGrid::reset(const int width, const int height, const GroundState& state)
+	{
+		m_width = width > 0 ? width : 0;
+		m_height = height > 0 ? height : 0;
+		m_chunk_columns = (m_width + ground_chunk_size - 1) / ground_chunk_size;
+		m_chunk_rows = (m_height + ground_chunk_size - 1) / ground_chunk_size;
+
+		m_chunks.clear();
+		m_chunks.resize(static_cast<size_t>(m_chunk_columns) * m_chunk_rows);
+		++m_version;
+
+		for(int cy = 0; cy < m_chunk_rows; ++cy)
+		{
+			for(int cx = 0; cx < m_chunk_columns; ++cx)
+			{
+				m_chunks[static_cast<size_t>(cy) * m_chunk_columns + cx].uniform_state = state;
+				update_summary(cx, cy);
+			}
+		}
+	}
+
+	inline int GroundGrid::get_width() const
+	{
+		return m_width;
+	}
+
+	inline int GroundGrid::get_height() const
+	{
+		return m_height;
+	}
+
+	inline int GroundGrid::get_words_per_row() const
+	{
+		return m_chunk_columns * ground_chunk_row_words;
+	}
+
+	inline bool GroundGrid::is_in_bound(const int x, const int y) const
+	{
+		return x >= 0 && x < m_width && y >= 0 && y < m_height;
+	}
+
+	inline int GroundGrid::get_chunk_columns() const
+	{
+		return m_chunk_columns;
+	}
+
+	inline int GroundGrid::get_chunk_rows() const
+	{
+		return m_chunk_rows;
+	}
+
+	inline const GroundChunk& GroundGrid::get_chunk(const int chunk_x, const int chunk_y) const
+	{
+		return m_chunks[static_cast<size_t>(chunk_y) * m_chunk_columns + chunk_x];
+	}
+
+	inline RECT GroundGrid::get_chunk_rect(const int chunk_x, const int chunk_y) const
+	{
+		return
+		{
+			chunk_x * ground_chunk_size,
+			chunk_y * ground_chunk_size,
+			(std::min)((chunk_x + 1) * ground_chunk_size, m_width),
+			(std::min)((chunk_y + 1) * ground_chunk_size, m_height)
+		};
+	}
+
+	inline void GroundGrid::refresh(const RECT& region)
+	{
+		if(m_width == 0 || m_height == 0)
+		{
+			return;
+		}
+
+		++m_version;
+
+		const int first_x = (std::max)(static_cast<int>(region.left), 0) / ground_chunk_size;
+		const int first_y = (std::max)(static_cast<int>(region.top), 0) / ground_chunk_size;
+		const int last_x = (std::min)(static_cast<int>(region.right) - 1, m_width - 1) / ground_chunk_size;
+		const int last_y = (std::min)(static_cast<int>(region.bottom) - 1, m_height - 1) / ground_chunk_size;
+
+		for(int cy = first_y; cy <= last_y; ++cy)
+		{
+			for(int cx = first_x; cx <= last_x; ++cx)
+			{
+				GroundChunk& chunk = m_chunks[static_cast<size_t>(cy) * m_chunk_columns + cx];
+
+				if(chunk.is_uniform())
+				{
+					update_summary(cx, cy);
+					continue;
+				}
+
+				// padding of the edge chunks is not a part of the table.
+				const RECT rect = get_chunk_rect(cx, cy);
+				const int valid_columns = rect.right - rect.left;
+				const int valid_rows = rect.bottom - rect.top;
+				const auto candidate = static_cast<GroundState>((*chunk.data)[0] & ground_pixel_mask);
+				const GroundWord pattern = fill_pattern(candidate);
+				bool uniform = true;
+
+				for(int r = 0; r < valid_rows && uniform; ++r)
+				{
+					for(int w = 0; w < ground_chunk_row_words && uniform; ++w)
+					{
+						const int column_begin = w * ground_pixels_per_word;
+						const int column_end = (std::min)(column_begin + ground_pixels_per_word, valid_columns);
+
+						if(column_begin >= column_end)
+						{
+							break;
+						}
+
+						const GroundWord mask = bit_range_mask(
+							0, (column_end - column_begin) * ground_bits_per_pixel);
+
+						uniform = (((*chunk.data)[r * ground_chunk_row_words + w] ^ pattern) & mask) == 0;
+					}
+				}
+
+				if(uniform)
+				{
+					chunk.data.reset();
+					chunk.uniform_state = candidate;
+				}
+
+				update_summary(cx, cy);
+			}
+		}
+	}
+
+	inline uint64_t GroundGrid::get_version() const
+	{
+		return m_version;
+	}
+
+	inline GroundSnapshot GroundGrid::snapshot() const
+	{
+		return {m_version, m_width, m_height, m_chunks};
+	}
+
+	inline bool GroundGrid::restore(const GroundSnapshot& snapshot, std::vector<RECT>& changed)
+	{
+		if(snapshot.width != m_width || snapshot.height != m_height)
+		{
+			return false;
+		}
+
+		for(int cy = 0; cy < m_chunk_rows; ++cy)
+		{
+			for(int cx = 0; cx < m_chunk_columns; ++cx)
+			{
+				const size_t index = static_cast<size_t>(cy) * m_chunk_columns + cx;
+				GroundChunk& chunk = m_chunks[index];
+				const GroundChunk& saved = snapshot.chunks[index];
+
+				// untouched chunks still share the data with the snapshot.
+				if(chunk.data == saved.data && (chunk.data || chunk.uniform_state == saved.uniform_state))
+				{
+					continue;
+				}
+
+				chunk = saved;
+				changed.push_back(get_chunk_rect(cx, cy));
+			}
+		}
+
+		++m_version;
+		return true;
+	}
+
+	inline void GroundGrid::assign_chunk(const int chunk_x, const int chunk_y, const GroundChunkData& words)
+	{
+		GroundChunk& chunk = m_chunks[static_cast<size_t>(chunk_y) * m_chunk_columns + chunk_x];
+		chunk.data = std::make_shared<GroundChunkData>(words);
+	}
+
+	inline bool GroundGrid::is_block_empty(const int x, const int y) const
+	{
+		const int bit = (y % ground_chunk_size) / ground_block_size * ground_chunk_blocks + 
+			(x % ground_chunk_size) / ground_block_size;
+		return !(get_chunk_of(x, y).any_solid & (1ull << bit));
+	}
+
+	inline bool GroundGrid::is_block_solid(const int x, const int y) const
+	{
+		const int bit = (y % ground_chunk_size) / ground_block_size * ground_chunk_blocks + 
+			(x % ground_chunk_size) / ground_block_size;
+		return get_chunk_of(x, y).all_solid & (1ull << bit);
+	}
+
+	inline bool GroundGrid::is_chunk_empty(const int x, const int y) const
+	{
+		return get_chunk_of(x, y).is_empty();
+	}
+
+	inline bool GroundGrid::is_chunk_solid(const int x, const int y) const
+	{
+		return get_chunk_of(x, y).is_solid();
+	}
+
+	inline bool GroundGrid::is_region_empty(const RECT& region) const
+	{
+		return is_region_uniform(region, false);
+	}
+
+	inline bool GroundGrid::is_region_solid(const RECT& region) const
+	{
+		return is_region_uniform(region, true);
+	}
+
+	inline GroundState GroundGrid::get(const int x, const int y) const
+	{
+		const GroundChunk& chunk = get_chunk_of(x, y);
+
+		if(chunk.is_uniform())
+		{
+			return chunk.uniform_state;
+		}
+
+		const GroundWord word = (*chunk.data)[
+			(y % ground_chunk_size) * ground_chunk_row_words + (x % ground_chunk_size) / ground_pixels_per_word];
+
+		return static_cast<GroundState>((word >> to_bit_shift(x)) & ground_pixel_mask);
+	}
+
+	inline void GroundGrid::set(const int x, const int y, const GroundState& state)
+	{
+		if(get_chunk_of(x, y).is_uniform(state))
+		{
+			return;
+		}
+
+		GroundWord& word = get_writable_word(to_word_x(x), y);
+		const int shift = to_bit_shift(x);
+
+		word &= ~(ground_pixel_mask << shift);
+		word |= (static_cast<GroundWord>(state) & ground_pixel_mask) << shift;
+	}
+
+	inline GroundWord GroundGrid::get_word(const int word_x, const int y) const
+	{
+		const GroundChunk& chunk = get_chunk_of(word_x * ground_pixels_per_word, y);
+
+		if(chunk.is_uniform())
+		{
+			return fill_pattern(chunk.uniform_state);
+		}
+
+		return (*chunk.data)[(y % ground_chunk_size) * ground_chunk_row_words + word_x % ground_chunk_row_words];
+	}
+
+	inline void GroundGrid::set_word(const int word_x, const int y, const GroundWord word)
+	{
+		get_writable_word(word_x, y) = word;
+	}
+
+	inline void GroundGrid::fill_span(const int y, const int x_begin, const int x_end, const GroundState& state)
+	{
+		const GroundWord pattern = fill_pattern(state);
+
+		visit_span(y, x_begin, x_end, state, [&](const int word_x, const GroundWord mask)
+		{
+			GroundWord& word = get_writable_word(word_x, y);
+			word = (word & ~mask) | (pattern & mask);
+		});
+	}
+
+	inline void GroundGrid::prepare_span(const int y, const int x_begin, const int x_end, const GroundState& state)
+	{
+		visit_span(y, x_begin, x_end, state, [&](const int word_x, const GroundWord)
+		{
+			materialize(get_chunk_of(word_x * ground_pixels_per_word, y));
+		});
+	}
+
+	inline void GroundGrid::fill_span_atomic(const int y, const int x_begin, const int x_end, const GroundState& state)
+	{
+		const GroundWord pattern = fill_pattern(state);
+
+		visit_span(y, x_begin, x_end, state, [&](const int word_x, const GroundWord mask)
+		{
+			const GroundChunk& chunk = get_chunk_of(word_x * ground_pixels_per_word, y);
+			GroundWord& word = (*chunk.data)[(y % ground_chunk_size) * ground_chunk_row_words + word_x % ground_chunk_row_words];
+			const auto target = reinterpret_cast<volatile long long*>(&word);
+
+			// set and cleared bits do not overlap, the order between the writers does not matter.
+			if(const GroundWord set_bits = pattern & mask)
+			{
+				_InterlockedOr64(target, static_cast<long long>(set_bits));
+			}
+
+			if(const GroundWord clear_bits = ~pattern & mask)
+			{
+				_InterlockedAnd64(target, static_cast<long long>(~clear_bits));
+			}
+		});
+	}
+
+	inline int GroundGrid::find_in_row(
+		const int y, const int x_from, const int x_to, const GroundState& state, const bool match) const
+	{
+		if(y < 0 || y >= m_height)
+		{
+			return -1;
+		}
+
+		const bool forward = x_from <= x_to;
+		const int begin = (std::max)(forward ? x_from : x_to, 0);
+		const int end = (std::min)(forward ? x_to : x_from, m_width - 1);
+
+		if(begin > end)
+		{
+			return -1;
+		}
+
+		const int first_word = to_word_x(begin);
+		const int last_word = to_word_x(end);
+
+		for(int n = 0; n <= last_word - first_word; ++n)
+		{
+			const int i = forward ? first_word + n : last_word - n;
+			const int bit_begin = i == first_word ? to_bit_shift(begin) : 0;
+			const int bit_end = i == last_word ? to_bit_shift(end) + ground_bits_per_pixel : 64;
+			const GroundWord state_bits = match ? 
+				match_state(get_word(i, y), state) : 
+				~match_state(get_word(i, y), state) & ground_lower_bits;
+			const GroundWord matched = state_bits & bit_range_mask(bit_begin, bit_end);
+
+			if(matched)
+			{
+				unsigned long bit;
+
+				if(forward)
+				{
+					_BitScanForward64(&bit, matched);
+				}
+				else
+				{
+					_BitScanReverse64(&bit, matched);
+				}
+
+				return i * ground_pixels_per_word + static_cast<int>(bit) / ground_bits_per_pixel;
+			}
+		}
+
+		return -1;
+	}
+
+	/**
+	 * \brief Gets the word that every pixel has the given state.
+	 */
+	inline GroundWord GroundGrid::fill_pattern(const GroundState& state)
+	{
+		return ground_lower_bits * (static_cast<GroundWord>(state) & ground_pixel_mask);
+	}
+
+	inline int GroundGrid::to_word_x(const int x)
+	{
+		return x / ground_pixels_per_word;
+	}
+
+	inline int GroundGrid::to_bit_shift(const int x)
+	{
+		return (x % ground_pixels_per_word) * ground_bits_per_pixel;
+	}
+
+	inline GroundWord GroundGrid::match_state(const GroundWord word, const GroundState& state)
+	{
+		const GroundWord diff = word ^ fill_pattern(state);
+		return ~(diff | (diff >> 1)) & ground_lower_bits;
+	}
+
+	// bits [bit_begin, bit_end) are set.
+	inline GroundWord GroundGrid::bit_range_mask(const int bit_begin, const int bit_end)
+	{
+		const GroundWord upper = bit_end >= 64 ? ~0ull : (1ull << bit_end) - 1;
+		return upper & (~0ull << bit_begin);
+	}
+
+	inline GroundChunk& GroundGrid::get_chunk_of(const int x, const int y)
+	{
+		return m_chunks[static_cast<size_t>(y / ground_chunk_size) * m_chunk_columns + x / ground_chunk_size];
+	}
+
+	inline const GroundChunk& GroundGrid::get_chunk_of(const int x, const int y) const
+	{
+		return m_chunks[static_cast<size_t>(y / ground_chunk_size) * m_chunk_columns + x / ground_chunk_size];
+	}
+
+	inline GroundWord& GroundGrid::get_writable_word(const int word_x, const int y)
+	{
+		GroundChunk& chunk = get_chunk_of(word_x * ground_pixels_per_word, y);
+		materialize(chunk);
+
+		return (*chunk.data)[(y % ground_chunk_size) * ground_chunk_row_words + word_x % ground_chunk_row_words];
+	}
+
+	inline void GroundGrid::materialize(GroundChunk& chunk)
+	{
+		if(chunk.is_uniform())
+		{
+			chunk.data = std::make_shared<GroundChunkData>();
+			chunk.data->fill(fill_pattern(chunk.uniform_state));
+		}
+		else if(chunk.data.use_count() > 1)
+		{
+			// a snapshot holds the data.
+			chunk.data = std::make_shared<GroundChunkData>(*chunk.data);
+		}
+	}
+
+	template <typename Visitor>
+	void GroundGrid::visit_span(
+		const int y, const int x_begin, const int x_end, const GroundState& state, const Visitor& visitor)
+	{
+		const int begin = (std::max)(x_begin, 0);
+		const int end = (std::min)(x_end, m_width);
+
+		if(y < 0 || y >= m_height || begin >= end)
+		{
+			return;
+		}
+
+		const int first_word = to_word_x(begin);
+		const int last_word = to_word_x(end - 1);
+
+		for(int i = first_word; i <= last_word; ++i)
+		{
+			// nothing to write if the whole chunk is already in the state.
+			if(get_chunk_of(i * ground_pixels_per_word, y).is_uniform(state))
+			{
+				continue;
+			}
+
+			const int bit_begin = i == first_word ? to_bit_shift(begin) : 0;
+			const int bit_end = i == last_word ? to_bit_shift(end - 1) + ground_bits_per_pixel : 64;
+
+			visitor(i, bit_range_mask(bit_begin, bit_end));
+		}
+	}
+
+	inline uint64_t GroundGrid::get_valid_blocks(const int chunk_x, const int chunk_y) const
+	{
+		const RECT rect = get_chunk_rect(chunk_x, chunk_y);
+		const int block_columns = (rect.right - rect.left + ground_block_size - 1) / ground_block_size;
+		const int block_rows = (rect.bottom - rect.top + ground_block_size - 1) / ground_block_size;
+
+		const uint64_t row_bits = (1ull << block_columns) - 1;
+		uint64_t valid = 0;
+
+		for(int by = 0; by < block_rows; ++by)
+		{
+			valid |= row_bits << (by * ground_chunk_blocks);
+		}
+
+		return valid;
+	}
+
+	inline void GroundGrid::update_summary(const int chunk_x, const int chunk_y)
+	{
+		GroundChunk& chunk = m_chunks[static_cast<size_t>(chunk_y) * m_chunk_columns + chunk_x];
+		const uint64_t valid = get_valid_blocks(chunk_x, chunk_y);
+
+		if(chunk.is_uniform())
+		{
+			const bool solid = chunk.uniform_state == GroundState::NotDestroyed;
+			chunk.any_solid = solid ? valid : 0;
+			chunk.all_solid = solid ? ~0ull : ~valid;
+			return;
+		}
+
+		const RECT rect = get_chunk_rect(chunk_x, chunk_y);
+		const int valid_columns = rect.right - rect.left;
+		const int valid_rows = rect.bottom - rect.top;
+
+		chunk.any_solid = 0;
+		chunk.all_solid = ~valid;
+
+		for(int by = 0; by < ground_chunk_blocks; ++by)
+		{
+			for(int bx = 0; bx < ground_chunk_blocks; ++bx)
+			{
+				const uint64_t bit = 1ull << (by * ground_chunk_blocks + bx);
+
+				if(!(valid & bit))
+				{
+					continue;
+				}
+
+				const int column_begin = bx * ground_block_size;
+				const int column_end = (std::min)(column_begin + ground_block_size, valid_columns);
+				const int row_end = (std::min)((by + 1) * ground_block_size, valid_rows);
+				const GroundWord mask = bit_range_mask(
+					to_bit_shift(column_begin), 
+					to_bit_shift(column_end - 1) + ground_bits_per_pixel) & ground_lower_bits;
+
+				bool any = false;
+				bool all = true;
+
+				for(int r = by * ground_block_size; r < row_end; ++r)
+				{
+					const GroundWord solid = match_state(
+						(*chunk.data)[r * ground_chunk_row_words + column_begin / ground_pixels_per_word],
+						GroundState::NotDestroyed) & mask;
+
+					any |= solid != 0;
+					all &= solid == mask;
+				}
+
+				chunk.any_solid |= any ? bit : 0;
+				chunk.all_solid |= all ? bit : 0;
+			}
+		}
+	}
+
+	inline bool GroundGrid::is_region_uniform(const RECT& region, const bool solid) const
+	{
+		const int left = (std::max)(static_cast<int>(region.left), 0);
+		const int top = (std::max)(static_cast<int>(region.top), 0);
+		const int right = (std::min)(static_cast<int>(region.right), m_width);
+		const int bottom = (std::min)(static_cast<int>(region.bottom), m_height);
+
+		// nothing in the table.
+		if(left >= right || top >= bottom)
+		{
+			return !solid;
+		}
+
+		for(int cy = top / ground_chunk_size; cy <= (bottom - 1) / ground_chunk_size; ++cy)
+		{
+			for(int cx = left / ground_chunk_size; cx <= (right - 1) / ground_chunk_size; ++cx)
+			{
+				const GroundChunk& chunk = get_chunk(cx, cy);
+
+				if(solid ? chunk.is_solid() : chunk.is_empty())
+				{
+					continue;
+				}
+
+				if(solid ? chunk.is_empty() : chunk.is_solid())
+				{
+					return false;
+				}
+
+				const int block_left = (std::max)(left, cx * ground_chunk_size);
+				const int block_top = (std::max)(top, cy * ground_chunk_size);
+				const int block_right = (std::min)(right, (cx + 1) * ground_chunk_size);
+				const int block_bottom = (std::min)(bottom, (cy + 1) * ground_chunk_size);
+
+				for(int y = block_top; y < block_bottom; y = (y / ground_block_size + 1) * ground_block_size)
+				{
+					for(int x = block_left; x < block_right; x = (x / ground_block_size + 1) * ground_block_size)
+					{
+						if(solid ? is_block_solid(x, y) : is_block_empty(x, y))
+						{
+							continue;
+						}
+
+						// part of the block that is in the region.
+						const int x_end = (std::min)(block_right, (x / ground_block_size + 1) * ground_block_size);
+						const int y_end = (std::min)(block_bottom, (y / ground_block_size + 1) * ground_block_size);
+
+						for(int row = y; row < y_end; ++row)
+						{
+							if(find_in_row(row, x, x_end - 1, GroundState::NotDestroyed, !solid) != -1)
+							{
+								return false;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+}
+
+#endif // GROUNDGRID_HPP
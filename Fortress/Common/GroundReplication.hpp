@@ -0,0 +1,265 @@
+#pragma once
+#ifndef GROUNDREPLICATION_HPP
+#define GROUNDREPLICATION_HPP
+
+#include <cstring>
+
+#include "Crc32.h"
+#include "GroundGrid.hpp"
+
+namespace Fortress::Object
+{
+	enum class GroundChunkEncoding : uint8_t
+	{
+		Uniform = 0,
+		RunLength,
+		Raw
+	};
+
+	// raw words of the chunk, encoding never exceeds this.
+	constexpr size_t ground_chunk_encoded_max = sizeof(GroundChunkData);
+	// a run takes 16 bits, upper 2 bits for the state and the rest for the length - 1.
+	constexpr int ground_run_length_bits = 14;
+	constexpr int ground_run_length_mask = (1 << ground_run_length_bits) - 1;
+
+	/**
+	 * \brief Encodes and decodes the chunks of the table for the replication. only the pixels inside of
+	 * the table are encoded, and the padding of the edge chunks is cleared so that the same terrain has
+	 * the same checksum on every peer.
+	 */
+	class GroundChunkCodec
+	{
+	public:
+		static void read_chunk(const GroundGrid& grid, const int chunk_x, const int chunk_y, GroundChunkData& out);
+		static uint32_t get_checksum(const GroundChunkData& words);
+		static uint32_t get_checksum(const GroundGrid& grid, const int chunk_x, const int chunk_y);
+
+		// out should hold ground_chunk_encoded_max bytes, returns the written size.
+		static size_t encode(
+			const GroundGrid& grid,
+			const int chunk_x,
+			const int chunk_y,
+			GroundChunkEncoding& encoding,
+			uint8_t* out);
+		// returns false if the data does not fit to the chunk.
+		static bool decode(
+			const GroundGrid& grid,
+			const int chunk_x,
+			const int chunk_y,
+			const GroundChunkEncoding encoding,
+			const uint8_t* data,
+			const size_t size,
+			GroundChunkData& out);
+
+	private:
+		static void clear_padding(const RECT& rect, GroundChunkData& words);
+	};
+
+	inline void GroundChunkCodec::read_chunk(
+		const GroundGrid& grid, const int chunk_x, const int chunk_y, GroundChunkData& out)
+	{
+		for(int r = 0; r < ground_chunk_size; ++r)
+		{
+			for(int w = 0; w < ground_chunk_row_words; ++w)
+			{
+				out[r * ground_chunk_row_words + w] = grid.get_word(
+					chunk_x * ground_chunk_row_words + w,
+					chunk_y * ground_chunk_size + r);
+			}
+		}
+
+		clear_padding(grid.get_chunk_rect(chunk_x, chunk_y), out);
+	}
+
+	inline uint32_t GroundChunkCodec::get_checksum(const GroundChunkData& words)
+	{
+		return crc32_fast(words.data(), sizeof(GroundChunkData));
+	}
+
+	inline uint32_t GroundChunkCodec::get_checksum(const GroundGrid& grid, const int chunk_x, const int chunk_y)
+	{
+		GroundChunkData words;
+		read_chunk(grid, chunk_x, chunk_y, words);
+		return get_checksum(words);
+	}
+
+	inline size_t GroundChunkCodec::encode(
+		const GroundGrid& grid,
+		const int chunk_x,
+		const int chunk_y,
+		GroundChunkEncoding& encoding,
+		uint8_t* out)
+	{
+		const GroundChunk& chunk = grid.get_chunk(chunk_x, chunk_y);
+
+		if(chunk.is_uniform())
+		{
+			encoding = GroundChunkEncoding::Uniform;
+			out[0] = static_cast<uint8_t>(chunk.uniform_state);
+			return 1;
+		}
+
+		const RECT rect = grid.get_chunk_rect(chunk_x, chunk_y);
+		const int columns = rect.right - rect.left;
+		const int rows = rect.bottom - rect.top;
+		const size_t raw_size = static_cast<size_t>(rows) * ground_chunk_row_words * sizeof(GroundWord);
+
+		GroundChunkData words;
+		read_chunk(grid, chunk_x, chunk_y, words);
+
+		size_t size = 0;
+		bool fits = true;
+		int run_state = -1;
+		int run_length = 0;
+
+		const auto flush = [&]()
+		{
+			if(run_length == 0)
+			{
+				return;
+			}
+
+			if(size + 2 > raw_size)
+			{
+				fits = false;
+				return;
+			}
+
+			const auto run = static_cast<uint16_t>((run_state << ground_run_length_bits) | (run_length - 1));
+			out[size++] = static_cast<uint8_t>(run & 0xff);
+			out[size++] = static_cast<uint8_t>(run >> 8);
+		};
+
+		for(int y = 0; y < rows && fits; ++y)
+		{
+			for(int x = 0; x < columns && fits; ++x)
+			{
+				const int state = static_cast<int>(
+					(words[y * ground_chunk_row_words + GroundGrid::to_word_x(x)] >> GroundGrid::to_bit_shift(x)) &
+					ground_pixel_mask);
+
+				if(state == run_state)
+				{
+					++run_length;
+					continue;
+				}
+
+				flush();
+				run_state = state;
+				run_length = 1;
+			}
+		}
+
+		flush();
+
+		if(fits)
+		{
+			encoding = GroundChunkEncoding::RunLength;
+			return size;
+		}
+
+		// too noisy for the runs.
+		encoding = GroundChunkEncoding::Raw;
+		std::memcpy(out, words.data(), raw_size);
+		return raw_size;
+	}
+
+	inline bool GroundChunkCodec::decode(
+		const GroundGrid& grid,
+		const int chunk_x,
+		const int chunk_y,
+		const GroundChunkEncoding encoding,
+		const uint8_t* data,
+		const size_t size,
+		GroundChunkData& out)
+	{
+		const RECT rect = grid.get_chunk_rect(chunk_x, chunk_y);
+		const int columns = rect.right - rect.left;
+		const int rows = rect.bottom - rect.top;
+		const size_t raw_size = static_cast<size_t>(rows) * ground_chunk_row_words * sizeof(GroundWord);
+
+		out.fill(0);
+
+		switch(encoding)
+		{
+		case GroundChunkEncoding::Uniform:
+			if(size != 1 || data[0] > static_cast<uint8_t>(GroundState::OutOfBound))
+			{
+				return false;
+			}
+
+			out.fill(GroundGrid::fill_pattern(static_cast<GroundState>(data[0])));
+			break;
+		case GroundChunkEncoding::Raw:
+			if(size != raw_size)
+			{
+				return false;
+			}
+
+			std::memcpy(out.data(), data, raw_size);
+			break;
+		case GroundChunkEncoding::RunLength:
+		{
+			if(size % 2 != 0)
+			{
+				return false;
+			}
+
+			const int total = columns * rows;
+			int pixel = 0;
+
+			for(size_t i = 0; i < size; i += 2)
+			{
+				const int run = data[i] | (data[i + 1] << 8);
+				const auto state = static_cast<GroundWord>(run >> ground_run_length_bits);
+				const int length = (run & ground_run_length_mask) + 1;
+
+				if(pixel + length > total)
+				{
+					return false;
+				}
+
+				for(const int end = pixel + length; pixel < end; ++pixel)
+				{
+					const int x = pixel % columns;
+					const int y = pixel / columns;
+					out[y * ground_chunk_row_words + GroundGrid::to_word_x(x)] |= state << GroundGrid::to_bit_shift(x);
+				}
+			}
+
+			if(pixel != total)
+			{
+				return false;
+			}
+
+			break;
+		}
+		default:
+			return false;
+		}
+
+		clear_padding(rect, out);
+		return true;
+	}
+
+	inline void GroundChunkCodec::clear_padding(const RECT& rect, GroundChunkData& words)
+	{
+		const int columns = rect.right - rect.left;
+		const int rows = rect.bottom - rect.top;
+
+		for(int r = 0; r < ground_chunk_size; ++r)
+		{
+			for(int w = 0; w < ground_chunk_row_words; ++w)
+			{
+				const int column_begin = w * ground_pixels_per_word;
+				const int valid = r < rows ?
+					(std::min)(ground_pixels_per_word, columns - column_begin) : 0;
+
+				words[r * ground_chunk_row_words + w] &= valid > 0 ?
+					GroundGrid::bit_range_mask(0, valid * ground_bits_per_pixel) : 0;
+			}
+		}
+	}
+}
+
+#endif // GROUNDREPLICATION_HPP
@@ -0,0 +1,206 @@
+#pragma once
+#ifndef GROUNDSURFACEINDEX_HPP
+#define GROUNDSURFACEINDEX_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include "GroundGrid.hpp"
+
+namespace Fortress::Object
+{
+	// solid rows [top, bottom) of a column.
+	struct SurfaceRun
+	{
+		int top;
+		int bottom;
+	};
+
+	/**
+	 * \brief An index of solid (NotDestroyed) runs per column, sorted from top to bottom.
+	 * first run of the column is the top surface, the rest are under the overhangs.
+	 */
+	class GroundSurfaceIndex
+	{
+	public:
+		GroundSurfaceIndex() : m_height(0)
+		{
+		}
+
+		GroundSurfaceIndex& operator=(const GroundSurfaceIndex& other) = default;
+		GroundSurfaceIndex& operator=(GroundSurfaceIndex&& other) = default;
+		GroundSurfaceIndex(const GroundSurfaceIndex& other) = default;
+		GroundSurfaceIndex(GroundSurfaceIndex&& other) = default;
+		~GroundSurfaceIndex() = default;
+
+		void rebuild(const GroundGrid& grid);
+		// rebuilds columns [x_begin, x_end), out of bound part is clipped.
+		void rebuild_columns(const GroundGrid& grid, const int x_begin, const int x_end);
+
+		bool is_in_bound(const int x) const;
+		const std::vector<SurfaceRun>& get_runs(const int x) const;
+		// returns height if the column has no solid row.
+		int get_top(const int x) const;
+		bool is_solid(const int x, const int y) const;
+
+		// first solid row in [y_begin, y_end), -1 if not found.
+		int find_solid_downward(const int x, const int y_begin, const int y_end) const;
+		// last non-solid row in [y_end, y_begin], -1 if not found.
+		int find_empty_upward(const int x, const int y_begin, const int y_end) const;
+
+	private:
+		// first run that its bottom is below the y.
+		std::vector<SurfaceRun>::const_iterator find_run(const int x, const int y) const;
+		void rebuild_column(const GroundGrid& grid, const int x);
+
+		int m_height;
+		std::vector<std::vector<SurfaceRun>> m_columns;
+	};
+
+	inline void GroundSurfaceIndex::rebuild(const GroundGrid& grid)
+	{
+		m_height = grid.get_height();
+		m_columns.resize(grid.get_width());
+		rebuild_columns(grid, 0, grid.get_width());
+	}
+
+	inline void GroundSurfaceIndex::rebuild_columns(const GroundGrid& grid, const int x_begin, const int x_end)
+	{
+		if(static_cast<int>(m_columns.size()) != grid.get_width() || m_height != grid.get_height())
+		{
+			m_height = grid.get_height();
+			m_columns.resize(grid.get_width());
+		}
+
+		const int begin = (std::max)(x_begin, 0);
+		const int end = (std::min)(x_end, grid.get_width());
+
+		for(int x = begin; x < end; ++x)
+		{
+			rebuild_column(grid, x);
+		}
+	}
+
+	inline bool GroundSurfaceIndex::is_in_bound(const int x) const
+	{
+		return x >= 0 && x < static_cast<int>(m_columns.size());
+	}
+
+	inline const std::vector<SurfaceRun>& GroundSurfaceIndex::get_runs(const int x) const
+	{
+		return m_columns[x];
+	}
+
+	inline int GroundSurfaceIndex::get_top(const int x) const
+	{
+		const auto& runs = m_columns[x];
+		return runs.empty() ? m_height : runs.front().top;
+	}
+
+	inline bool GroundSurfaceIndex::is_solid(const int x, const int y) const
+	{
+		const auto it = find_run(x, y);
+		return it != m_columns[x].end() && it->top <= y;
+	}
+
+	inline int GroundSurfaceIndex::find_solid_downward(const int x, const int y_begin, const int y_end) const
+	{
+		const int begin = (std::max)(y_begin, 0);
+		const int end = (std::min)(y_end, m_height);
+
+		if(begin >= end)
+		{
+			return -1;
+		}
+
+		const auto it = find_run(x, begin);
+
+		if(it == m_columns[x].end())
+		{
+			return -1;
+		}
+
+		const int found = (std::max)(it->top, begin);
+		return found < end ? found : -1;
+	}
+
+	inline int GroundSurfaceIndex::find_empty_upward(const int x, const int y_begin, const int y_end) const
+	{
+		const int begin = (std::min)(y_begin, m_height - 1);
+		const int end = (std::max)(y_end, 0);
+
+		if(begin < end)
+		{
+			return -1;
+		}
+
+		const auto it = find_run(x, begin);
+
+		if(it == m_columns[x].end() || it->top > begin)
+		{
+			return begin;
+		}
+
+		// runs are maximal, the row right above the run is empty or out of bound.
+		const int found = it->top - 1;
+		return found >= end ? found : -1;
+	}
+
+	inline std::vector<SurfaceRun>::const_iterator GroundSurfaceIndex::find_run(const int x, const int y) const
+	{
+		const auto& runs = m_columns[x];
+
+		return std::upper_bound(
+			runs.begin(), runs.end(), y,
+			[](const int value, const SurfaceRun& run)
+			{
+				return value < run.bottom;
+			});
+	}
+
+	inline void GroundSurfaceIndex::rebuild_column(const GroundGrid& grid, const int x)
+	{
+		auto& runs = m_columns[x];
+		runs.clear();
+
+		int top = -1;
+		const auto visit = [&](const int y, const bool solid)
+		{
+			if(solid && top == -1)
+			{
+				top = y;
+			}
+			else if(!solid && top != -1)
+			{
+				runs.push_back({top, y});
+				top = -1;
+			}
+		};
+
+		for(int chunk_y = 0; chunk_y < grid.get_chunk_rows(); ++chunk_y)
+		{
+			const GroundChunk& chunk = grid.get_chunk(x / ground_chunk_size, chunk_y);
+			const int y_begin = chunk_y * ground_chunk_size;
+			const int y_end = (std::min)(y_begin + ground_chunk_size, m_height);
+
+			// uniform chunk is a single step of the run.
+			if(chunk.is_uniform())
+			{
+				visit(y_begin, chunk.uniform_state == GroundState::NotDestroyed);
+				continue;
+			}
+
+			for(int y = y_begin; y < y_end; ++y)
+			{
+				visit(y, grid.get(x, y) == GroundState::NotDestroyed);
+			}
+		}
+
+		if(top != -1)
+		{
+			runs.push_back({top, m_height});
+		}
+	}
+}
+
+#endif // GROUNDSURFACEINDEX_HPP
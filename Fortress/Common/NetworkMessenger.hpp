@@ -81,6 +81,16 @@ namespace Fortress::Network
 			});
 		}
 
+		// message from any other player of the room.
+		template <typename T = Message>
+		bool pop_peer_message(const eMessageType type, T* out)
+		{
+			return m_soc.find_message<T>(type, out, [&](const T* msg)
+			{
+				return msg->room_id == m_rood_id_ && msg->player_id != m_player_id;
+			});
+		}
+
 	private:
 		template <typename SendT, typename RecvT = Message>
 		inline void send_and_retry(
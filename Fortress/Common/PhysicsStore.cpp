@@ -0,0 +1,25 @@
+#include "pch.h"
+#include "PhysicsStore.hpp"
+
+#include "rigidBody.hpp"
+
+namespace Fortress::Abstract
+{
+	void PhysicsStore::flush()
+	{
+		for(size_t i = 0; i < m_flags.size(); ++i)
+		{
+			if(!(m_flags[i] & Pending))
+			{
+				continue;
+			}
+
+			rigidBody* owner = m_owners[i];
+			owner->m_position = {m_x[i], m_y[i]};
+			owner->m_curr_speed = {m_speed_x[i], m_speed_y[i]};
+			owner->m_gravity_speed = m_gravity_speed[i];
+
+			m_flags[i] &= ~Pending;
+		}
+	}
+}
@@ -0,0 +1,574 @@
+#pragma once
+#ifndef PHYSICSSTORE_HPP
+#define PHYSICSSTORE_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+#include "fixed.hpp"
+#include "vector2.hpp"
+
+namespace Fortress::Abstract
+{
+	constexpr float max_gravity_speed = 1000000000.0f;
+
+	class rigidBody;
+
+	enum ePhysicsFlag : uint32_t
+	{
+		// written by the update of this step, cleared by the integration.
+		Pending = 1 << 0,
+		Gravity = 1 << 1,
+	};
+
+	// state of the body in the store, also the input of the integration.
+	struct PhysicsState
+	{
+		Math::Vector2 position;
+		Math::Vector2 velocity;
+		Math::Vector2 base_speed;
+		Math::Vector2 speed;
+		Math::Vector2 acceleration;
+		float half_height;
+		float gravity_speed;
+		float gravity_acceleration;
+		bool gravity;
+	};
+
+	/**
+	 * \brief Keeps the integration state of the rigid bodies in the contiguous arrays. the bodies write their state
+	 * in their update, and the scene advances all of them at once after the layers are updated.
+	 */
+	class PhysicsStore
+	{
+	public:
+		PhysicsStore() = delete;
+		PhysicsStore& operator=(const PhysicsStore& other) = delete;
+		PhysicsStore& operator=(PhysicsStore&& other) = delete;
+		PhysicsStore(const PhysicsStore& other) = delete;
+		PhysicsStore(PhysicsStore&& other) = delete;
+		~PhysicsStore() = delete;
+
+		static int allocate();
+		static void release(int index);
+		static void write(int index, rigidBody* owner, const PhysicsState& state);
+		static size_t size();
+
+		// advances the pending bodies by delta time, the bottom of the bodies stops at the floor.
+		static void integrate(float dt, float floor);
+		// copies the integrated state back to the bodies and clears the pending.
+		static void flush();
+
+		// kernel on the raw arrays in [begin, end), the vectorized one leaves the tail to this.
+		static void integrate_scalar(size_t begin, size_t end, float dt, float floor);
+		static size_t integrate_vectorized(float dt, float floor);
+
+		// position, speed and gravity speed are stepped in the fixed-point, so the rounding of the integration does
+		// not depend on the floating point environment. the bodies and the collisions stay in float, so the peers
+		// are not in lockstep by this alone.
+		static void set_fixed_point(bool fixed_point);
+		static bool is_fixed_point();
+		static void integrate_fixed(float dt, float floor);
+
+	private:
+		inline static std::vector<float> m_x = {};
+		inline static std::vector<float> m_y = {};
+		inline static std::vector<float> m_vx = {};
+		inline static std::vector<float> m_vy = {};
+		inline static std::vector<float> m_base_speed_x = {};
+		inline static std::vector<float> m_base_speed_y = {};
+		inline static std::vector<float> m_speed_x = {};
+		inline static std::vector<float> m_speed_y = {};
+		inline static std::vector<float> m_acceleration_x = {};
+		inline static std::vector<float> m_acceleration_y = {};
+		inline static std::vector<float> m_half_height = {};
+		inline static std::vector<float> m_gravity_speed = {};
+		inline static std::vector<float> m_gravity_acceleration = {};
+		inline static std::vector<uint32_t> m_flags = {};
+
+		inline static bool m_fixed_point = false;
+		inline static std::vector<Math::Fixed> m_fixed_x = {};
+		inline static std::vector<Math::Fixed> m_fixed_y = {};
+		inline static std::vector<Math::Fixed> m_fixed_speed_x = {};
+		inline static std::vector<Math::Fixed> m_fixed_speed_y = {};
+		inline static std::vector<Math::Fixed> m_fixed_gravity_speed = {};
+
+		// cold, only touched by the write and the flush.
+		inline static std::vector<rigidBody*> m_owners = {};
+		inline static std::vector<int> m_free = {};
+	};
+
+	/**
+	 * \brief Owns a slot of the store. a copy takes its own slot, the state is written again in the next update.
+	 */
+	class PhysicsHandle
+	{
+	public:
+		PhysicsHandle() : m_index(PhysicsStore::allocate())
+		{
+		}
+
+		PhysicsHandle(const PhysicsHandle&) : m_index(PhysicsStore::allocate())
+		{
+		}
+
+		PhysicsHandle(PhysicsHandle&& other) noexcept : m_index(other.m_index)
+		{
+			other.m_index = -1;
+		}
+
+		PhysicsHandle& operator=(const PhysicsHandle&)
+		{
+			return *this;
+		}
+
+		PhysicsHandle& operator=(PhysicsHandle&& other) noexcept
+		{
+			if(this != &other)
+			{
+				PhysicsStore::release(m_index);
+				m_index = other.m_index;
+				other.m_index = -1;
+			}
+
+			return *this;
+		}
+
+		~PhysicsHandle()
+		{
+			PhysicsStore::release(m_index);
+		}
+
+		int get() const
+		{
+			return m_index;
+		}
+
+	private:
+		int m_index;
+	};
+
+	inline int PhysicsStore::allocate()
+	{
+		if(!m_free.empty())
+		{
+			const int index = m_free.back();
+			m_free.pop_back();
+			return index;
+		}
+
+		m_x.push_back(0.0f);
+		m_y.push_back(0.0f);
+		m_vx.push_back(0.0f);
+		m_vy.push_back(0.0f);
+		m_base_speed_x.push_back(0.0f);
+		m_base_speed_y.push_back(0.0f);
+		m_speed_x.push_back(0.0f);
+		m_speed_y.push_back(0.0f);
+		m_acceleration_x.push_back(0.0f);
+		m_acceleration_y.push_back(0.0f);
+		m_half_height.push_back(0.0f);
+		m_gravity_speed.push_back(0.0f);
+		m_gravity_acceleration.push_back(0.0f);
+		m_flags.push_back(0);
+		m_fixed_x.emplace_back();
+		m_fixed_y.emplace_back();
+		m_fixed_speed_x.emplace_back();
+		m_fixed_speed_y.emplace_back();
+		m_fixed_gravity_speed.emplace_back();
+		m_owners.push_back(nullptr);
+
+		return static_cast<int>(m_flags.size()) - 1;
+	}
+
+	inline void PhysicsStore::release(const int index)
+	{
+		if(index < 0)
+		{
+			return;
+		}
+
+		// body is gone before the flush.
+		m_flags[index] = 0;
+		m_owners[index] = nullptr;
+		m_free.push_back(index);
+	}
+
+	inline void PhysicsStore::write(const int index, rigidBody* owner, const PhysicsState& state)
+	{
+		if(m_fixed_point)
+		{
+			// values that are same as the last flush are not touched by the game, the fixed-point is kept.
+			const auto requantize = [](std::vector<Math::Fixed>& fixed, const std::vector<float>& flushed, const int i, const float value)
+			{
+				if(flushed[i] != value)
+				{
+					fixed[i] = Math::Fixed::from_float(value);
+				}
+			};
+
+			requantize(m_fixed_x, m_x, index, state.position.get_x());
+			requantize(m_fixed_y, m_y, index, state.position.get_y());
+			requantize(m_fixed_speed_x, m_speed_x, index, state.speed.get_x());
+			requantize(m_fixed_speed_y, m_speed_y, index, state.speed.get_y());
+			requantize(m_fixed_gravity_speed, m_gravity_speed, index, state.gravity_speed);
+		}
+
+		m_x[index] = state.position.get_x();
+		m_y[index] = state.position.get_y();
+		m_vx[index] = state.velocity.get_x();
+		m_vy[index] = state.velocity.get_y();
+		m_base_speed_x[index] = state.base_speed.get_x();
+		m_base_speed_y[index] = state.base_speed.get_y();
+		m_speed_x[index] = state.speed.get_x();
+		m_speed_y[index] = state.speed.get_y();
+		m_acceleration_x[index] = state.acceleration.get_x();
+		m_acceleration_y[index] = state.acceleration.get_y();
+		m_half_height[index] = state.half_height;
+		m_gravity_speed[index] = state.gravity_speed;
+		m_gravity_acceleration[index] = state.gravity_acceleration;
+		m_flags[index] = Pending | (state.gravity ? Gravity : 0);
+		m_owners[index] = owner;
+	}
+
+	inline size_t PhysicsStore::size()
+	{
+		return m_flags.size();
+	}
+
+	inline void PhysicsStore::integrate(const float dt, const float floor)
+	{
+		if(m_fixed_point)
+		{
+			integrate_fixed(dt, floor);
+			return;
+		}
+
+		const size_t done = integrate_vectorized(dt, floor);
+		integrate_scalar(done, m_flags.size(), dt, floor);
+	}
+
+	inline void PhysicsStore::integrate_scalar(const size_t begin, const size_t end, const float dt, const float floor)
+	{
+		const float half_dt = dt * 0.5f;
+
+		for(size_t i = begin; i < end; ++i)
+		{
+			if(!(m_flags[i] & Pending))
+			{
+				continue;
+			}
+
+			// current speed starts from the base speed when it is stopped.
+			if(m_speed_x[i] * m_speed_x[i] + m_speed_y[i] * m_speed_y[i] < Math::epsilon * Math::epsilon)
+			{
+				m_speed_x[i] = m_base_speed_x[i];
+				m_speed_y[i] = m_base_speed_y[i];
+			}
+
+			if(std::fabs(m_vx[i]) <= Math::epsilon && std::fabs(m_vy[i]) <= Math::epsilon)
+			{
+				m_speed_x[i] = 0.0f;
+				m_speed_y[i] = 0.0f;
+			}
+			else
+			{
+				m_speed_x[i] += m_acceleration_x[i] * half_dt;
+				m_speed_y[i] += m_acceleration_y[i] * half_dt;
+				m_x[i] += m_vx[i] * m_speed_x[i] * dt;
+				m_y[i] += m_vy[i] * m_speed_y[i] * dt;
+				m_speed_x[i] += m_acceleration_x[i] * half_dt;
+				m_speed_y[i] += m_acceleration_y[i] * half_dt;
+			}
+
+			if(!(m_flags[i] & Gravity))
+			{
+				continue;
+			}
+
+			if(std::fabs(m_y[i] + m_half_height[i] - floor) <= Math::epsilon)
+			{
+				m_gravity_speed[i] = 0.0f;
+			}
+			else if(m_gravity_speed[i] <= max_gravity_speed)
+			{
+				m_gravity_speed[i] += m_gravity_acceleration[i] * half_dt;
+				m_y[i] += m_gravity_speed[i] * dt;
+				m_gravity_speed[i] += m_gravity_acceleration[i] * half_dt;
+			}
+		}
+	}
+
+	inline void PhysicsStore::set_fixed_point(const bool fixed_point)
+	{
+		if(fixed_point && !m_fixed_point)
+		{
+			for(size_t i = 0; i < m_flags.size(); ++i)
+			{
+				m_fixed_x[i] = Math::Fixed::from_float(m_x[i]);
+				m_fixed_y[i] = Math::Fixed::from_float(m_y[i]);
+				m_fixed_speed_x[i] = Math::Fixed::from_float(m_speed_x[i]);
+				m_fixed_speed_y[i] = Math::Fixed::from_float(m_speed_y[i]);
+				m_fixed_gravity_speed[i] = Math::Fixed::from_float(m_gravity_speed[i]);
+			}
+		}
+
+		m_fixed_point = fixed_point;
+	}
+
+	inline bool PhysicsStore::is_fixed_point()
+	{
+		return m_fixed_point;
+	}
+
+	inline void PhysicsStore::integrate_fixed(const float dt, const float floor)
+	{
+		using Math::Fixed;
+
+		const Fixed fixed_dt = Fixed::from_float(dt);
+		const Fixed half_dt = Fixed::from_raw(fixed_dt.raw() / 2);
+		const Fixed fixed_floor = Fixed::from_float(floor);
+		const Fixed epsilon = Fixed::from_float(Math::epsilon);
+		const Fixed max_gravity = Fixed::from_raw(INT32_MAX);
+
+		for(size_t i = 0; i < m_flags.size(); ++i)
+		{
+			if(!(m_flags[i] & Pending))
+			{
+				continue;
+			}
+
+			const Fixed vx = Fixed::from_float(m_vx[i]);
+			const Fixed vy = Fixed::from_float(m_vy[i]);
+			const Fixed ax = Fixed::from_float(m_acceleration_x[i]);
+			const Fixed ay = Fixed::from_float(m_acceleration_y[i]);
+			Fixed& x = m_fixed_x[i];
+			Fixed& y = m_fixed_y[i];
+			Fixed& sx = m_fixed_speed_x[i];
+			Fixed& sy = m_fixed_speed_y[i];
+			Fixed& g = m_fixed_gravity_speed[i];
+
+			if(sx.abs() < epsilon && sy.abs() < epsilon)
+			{
+				sx = Fixed::from_float(m_base_speed_x[i]);
+				sy = Fixed::from_float(m_base_speed_y[i]);
+			}
+
+			if(vx.abs() <= epsilon && vy.abs() <= epsilon)
+			{
+				sx = {};
+				sy = {};
+			}
+			else
+			{
+				sx += ax * half_dt;
+				sy += ay * half_dt;
+				x += vx * sx * fixed_dt;
+				y += vy * sy * fixed_dt;
+				sx += ax * half_dt;
+				sy += ay * half_dt;
+			}
+
+			if(m_flags[i] & Gravity)
+			{
+				const Fixed ga = Fixed::from_float(m_gravity_acceleration[i]);
+
+				if((y + Fixed::from_float(m_half_height[i]) - fixed_floor).abs() <= epsilon)
+				{
+					g = {};
+				}
+				else if(g < max_gravity)
+				{
+					g += ga * half_dt;
+					y += g * fixed_dt;
+					g += ga * half_dt;
+				}
+			}
+
+			m_x[i] = x.to_float();
+			m_y[i] = y.to_float();
+			m_speed_x[i] = sx.to_float();
+			m_speed_y[i] = sy.to_float();
+			m_gravity_speed[i] = g.to_float();
+		}
+	}
+
+#if defined(__AVX2__)
+	inline size_t PhysicsStore::integrate_vectorized(const float dt, const float floor)
+	{
+		constexpr size_t lanes = 8;
+		const size_t count = m_flags.size() - m_flags.size() % lanes;
+
+		const __m256 v_dt = _mm256_set1_ps(dt);
+		const __m256 v_half_dt = _mm256_set1_ps(dt * 0.5f);
+		const __m256 v_floor = _mm256_set1_ps(floor);
+		const __m256 v_epsilon = _mm256_set1_ps(Math::epsilon);
+		const __m256 v_epsilon_sq = _mm256_set1_ps(Math::epsilon * Math::epsilon);
+		const __m256 v_max_gravity = _mm256_set1_ps(max_gravity_speed);
+		const __m256 v_zero = _mm256_setzero_ps();
+		const __m256 v_abs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+		const __m256i v_pending = _mm256_set1_epi32(Pending);
+		const __m256i v_gravity = _mm256_set1_epi32(Gravity);
+
+		for(size_t i = 0; i < count; i += lanes)
+		{
+			const __m256i flags = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(m_flags.data() + i));
+			const __m256 pending = _mm256_castsi256_ps(
+				_mm256_cmpeq_epi32(_mm256_and_si256(flags, v_pending), v_pending));
+
+			if(_mm256_movemask_ps(pending) == 0)
+			{
+				continue;
+			}
+
+			const __m256 gravity = _mm256_and_ps(pending, _mm256_castsi256_ps(
+				_mm256_cmpeq_epi32(_mm256_and_si256(flags, v_gravity), v_gravity)));
+
+			__m256 x = _mm256_loadu_ps(m_x.data() + i);
+			__m256 y = _mm256_loadu_ps(m_y.data() + i);
+			const __m256 vx = _mm256_loadu_ps(m_vx.data() + i);
+			const __m256 vy = _mm256_loadu_ps(m_vy.data() + i);
+			__m256 sx = _mm256_loadu_ps(m_speed_x.data() + i);
+			__m256 sy = _mm256_loadu_ps(m_speed_y.data() + i);
+			const __m256 ax = _mm256_loadu_ps(m_acceleration_x.data() + i);
+			const __m256 ay = _mm256_loadu_ps(m_acceleration_y.data() + i);
+			__m256 g = _mm256_loadu_ps(m_gravity_speed.data() + i);
+			const __m256 ga = _mm256_loadu_ps(m_gravity_acceleration.data() + i);
+
+			const __m256 stopped_speed = _mm256_cmp_ps(
+				_mm256_add_ps(_mm256_mul_ps(sx, sx), _mm256_mul_ps(sy, sy)), v_epsilon_sq, _CMP_LT_OQ);
+			sx = _mm256_blendv_ps(sx, _mm256_loadu_ps(m_base_speed_x.data() + i), stopped_speed);
+			sy = _mm256_blendv_ps(sy, _mm256_loadu_ps(m_base_speed_y.data() + i), stopped_speed);
+
+			const __m256 still = _mm256_and_ps(
+				_mm256_cmp_ps(_mm256_and_ps(vx, v_abs), v_epsilon, _CMP_LE_OQ),
+				_mm256_cmp_ps(_mm256_and_ps(vy, v_abs), v_epsilon, _CMP_LE_OQ));
+			const __m256 moving = _mm256_andnot_ps(still, pending);
+
+			const __m256 sx_half = _mm256_add_ps(sx, _mm256_mul_ps(ax, v_half_dt));
+			const __m256 sy_half = _mm256_add_ps(sy, _mm256_mul_ps(ay, v_half_dt));
+			x = _mm256_blendv_ps(x, _mm256_add_ps(x, _mm256_mul_ps(_mm256_mul_ps(vx, sx_half), v_dt)), moving);
+			y = _mm256_blendv_ps(y, _mm256_add_ps(y, _mm256_mul_ps(_mm256_mul_ps(vy, sy_half), v_dt)), moving);
+			sx = _mm256_blendv_ps(v_zero, _mm256_add_ps(sx_half, _mm256_mul_ps(ax, v_half_dt)), moving);
+			sy = _mm256_blendv_ps(v_zero, _mm256_add_ps(sy_half, _mm256_mul_ps(ay, v_half_dt)), moving);
+
+			const __m256 bottom = _mm256_add_ps(y, _mm256_loadu_ps(m_half_height.data() + i));
+			const __m256 grounded = _mm256_and_ps(gravity, _mm256_cmp_ps(
+				_mm256_and_ps(_mm256_sub_ps(bottom, v_floor), v_abs), v_epsilon, _CMP_LE_OQ));
+			const __m256 falling = _mm256_and_ps(
+				_mm256_andnot_ps(grounded, gravity), _mm256_cmp_ps(g, v_max_gravity, _CMP_LE_OQ));
+
+			const __m256 g_half = _mm256_add_ps(g, _mm256_mul_ps(ga, v_half_dt));
+			y = _mm256_blendv_ps(y, _mm256_add_ps(y, _mm256_mul_ps(g_half, v_dt)), falling);
+			g = _mm256_blendv_ps(g, _mm256_add_ps(g_half, _mm256_mul_ps(ga, v_half_dt)), falling);
+			g = _mm256_andnot_ps(grounded, g);
+
+			// lanes that are not pending keep the loaded values.
+			_mm256_storeu_ps(m_x.data() + i, x);
+			_mm256_storeu_ps(m_y.data() + i, y);
+			_mm256_storeu_ps(m_speed_x.data() + i, _mm256_blendv_ps(_mm256_loadu_ps(m_speed_x.data() + i), sx, pending));
+			_mm256_storeu_ps(m_speed_y.data() + i, _mm256_blendv_ps(_mm256_loadu_ps(m_speed_y.data() + i), sy, pending));
+			_mm256_storeu_ps(m_gravity_speed.data() + i, g);
+		}
+
+		return count;
+	}
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	inline size_t PhysicsStore::integrate_vectorized(const float dt, const float floor)
+	{
+		constexpr size_t lanes = 4;
+		const size_t count = m_flags.size() - m_flags.size() % lanes;
+
+		// no blend in sse2, selects by the mask.
+		const auto select = [](const __m128 if_false, const __m128 if_true, const __m128 mask)
+		{
+			return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+		};
+
+		const __m128 v_dt = _mm_set1_ps(dt);
+		const __m128 v_half_dt = _mm_set1_ps(dt * 0.5f);
+		const __m128 v_floor = _mm_set1_ps(floor);
+		const __m128 v_epsilon = _mm_set1_ps(Math::epsilon);
+		const __m128 v_epsilon_sq = _mm_set1_ps(Math::epsilon * Math::epsilon);
+		const __m128 v_max_gravity = _mm_set1_ps(max_gravity_speed);
+		const __m128 v_abs = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		const __m128i v_pending = _mm_set1_epi32(Pending);
+		const __m128i v_gravity = _mm_set1_epi32(Gravity);
+
+		for(size_t i = 0; i < count; i += lanes)
+		{
+			const __m128i flags = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_flags.data() + i));
+			const __m128 pending = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, v_pending), v_pending));
+
+			if(_mm_movemask_ps(pending) == 0)
+			{
+				continue;
+			}
+
+			const __m128 gravity = _mm_and_ps(pending, _mm_castsi128_ps(
+				_mm_cmpeq_epi32(_mm_and_si128(flags, v_gravity), v_gravity)));
+
+			__m128 x = _mm_loadu_ps(m_x.data() + i);
+			__m128 y = _mm_loadu_ps(m_y.data() + i);
+			const __m128 vx = _mm_loadu_ps(m_vx.data() + i);
+			const __m128 vy = _mm_loadu_ps(m_vy.data() + i);
+			const __m128 sx_loaded = _mm_loadu_ps(m_speed_x.data() + i);
+			const __m128 sy_loaded = _mm_loadu_ps(m_speed_y.data() + i);
+			const __m128 ax = _mm_loadu_ps(m_acceleration_x.data() + i);
+			const __m128 ay = _mm_loadu_ps(m_acceleration_y.data() + i);
+			__m128 g = _mm_loadu_ps(m_gravity_speed.data() + i);
+			const __m128 ga = _mm_loadu_ps(m_gravity_acceleration.data() + i);
+
+			const __m128 stopped_speed = _mm_cmplt_ps(
+				_mm_add_ps(_mm_mul_ps(sx_loaded, sx_loaded), _mm_mul_ps(sy_loaded, sy_loaded)), v_epsilon_sq);
+			const __m128 sx = select(sx_loaded, _mm_loadu_ps(m_base_speed_x.data() + i), stopped_speed);
+			const __m128 sy = select(sy_loaded, _mm_loadu_ps(m_base_speed_y.data() + i), stopped_speed);
+
+			const __m128 still = _mm_and_ps(
+				_mm_cmple_ps(_mm_and_ps(vx, v_abs), v_epsilon),
+				_mm_cmple_ps(_mm_and_ps(vy, v_abs), v_epsilon));
+			const __m128 moving = _mm_andnot_ps(still, pending);
+
+			const __m128 sx_half = _mm_add_ps(sx, _mm_mul_ps(ax, v_half_dt));
+			const __m128 sy_half = _mm_add_ps(sy, _mm_mul_ps(ay, v_half_dt));
+			x = select(x, _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(vx, sx_half), v_dt)), moving);
+			y = select(y, _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(vy, sy_half), v_dt)), moving);
+			const __m128 sx_next = _mm_and_ps(moving, _mm_add_ps(sx_half, _mm_mul_ps(ax, v_half_dt)));
+			const __m128 sy_next = _mm_and_ps(moving, _mm_add_ps(sy_half, _mm_mul_ps(ay, v_half_dt)));
+
+			const __m128 bottom = _mm_add_ps(y, _mm_loadu_ps(m_half_height.data() + i));
+			const __m128 grounded = _mm_and_ps(gravity,
+				_mm_cmple_ps(_mm_and_ps(_mm_sub_ps(bottom, v_floor), v_abs), v_epsilon));
+			const __m128 falling = _mm_and_ps(_mm_andnot_ps(grounded, gravity), _mm_cmple_ps(g, v_max_gravity));
+
+			const __m128 g_half = _mm_add_ps(g, _mm_mul_ps(ga, v_half_dt));
+			y = select(y, _mm_add_ps(y, _mm_mul_ps(g_half, v_dt)), falling);
+			g = select(g, _mm_add_ps(g_half, _mm_mul_ps(ga, v_half_dt)), falling);
+			g = _mm_andnot_ps(grounded, g);
+
+			// lanes that are not pending keep the loaded values.
+			_mm_storeu_ps(m_x.data() + i, x);
+			_mm_storeu_ps(m_y.data() + i, y);
+			_mm_storeu_ps(m_speed_x.data() + i, select(sx_loaded, sx_next, pending));
+			_mm_storeu_ps(m_speed_y.data() + i, select(sy_loaded, sy_next, pending));
+			_mm_storeu_ps(m_gravity_speed.data() + i, g);
+		}
+
+		return count;
+	}
+#else
+	inline size_t PhysicsStore::integrate_vectorized(float, float)
+	{
+		return 0;
+	}
+#endif
+}
+
+#endif // PHYSICSSTORE_HPP
@@ -36,6 +36,16 @@ namespace Fortress::Controller
 		set_state(eProjectileState::Fire);
 	}
 
+	void ProjectileController::reset(const unsigned int id)
+	{
+		m_id_ = id;
+		m_curr_hit_count = 0;
+		m_hit_cooldown = 0.0f;
+		m_bExploded = false;
+		m_pitch = 0.0f;
+		ProjectileController::initialize();
+	}
+
 	void ProjectileController::update()
 	{
 		m_hit_cooldown += DeltaTime::get_deltaTime();
@@ -129,6 +139,8 @@ namespace Fortress::Controller
 	void ProjectileController::fire_state()
 	{
 		fire();
+		// pooled projectile is left where it was destroyed.
+		m_previous_position = m_rb->get_position();
 		m_bExploded = false;
 		m_current_sprite.lock()->play();
 		play_fire_sound();
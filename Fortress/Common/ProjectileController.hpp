@@ -35,6 +35,8 @@ namespace Fortress::Controller
 		void initialize() override;
 		void update() override;
 		void prerender() override;
+		// counts and state of the creation, with the new id.
+		void reset(const unsigned int id);
 
 		bool is_cooldown() const;
 		bool is_exploded() const;
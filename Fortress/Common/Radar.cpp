@@ -1,19 +1,48 @@
 #include "pch.h"
 #include "Radar.h"
 #include "BattleScene.h"
+#include "FrameArena.hpp"
 
 namespace Fortress
 {
+	Radar::~Radar()
+	{
+		release();
+	}
+
 	void Radar::initialize()
 	{
+		release();
+
 		m_radar_hdc = CreateCompatibleDC(
 			EngineHandle::get_handle().lock()->get_main_dc());
 		m_radar_bitmap = CreateCompatibleBitmap(
-			EngineHandle::get_handle().lock()->get_main_dc(), m_map_size.get_x(), m_map_size.get_y());
+			EngineHandle::get_handle().lock()->get_main_dc(), m_width, m_height);
 
 		const auto previousBitmap = static_cast<HBITMAP>(SelectObject(m_radar_hdc, m_radar_bitmap));
 		DeleteObject(previousBitmap);
 
+		BITMAPINFO info{};
+		info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+		info.bmiHeader.biWidth = m_width;
+		// top-down
+		info.bmiHeader.biHeight = -m_height;
+		info.bmiHeader.biPlanes = 1;
+		info.bmiHeader.biBitCount = 32;
+		info.bmiHeader.biCompression = BI_RGB;
+
+		m_background_hdc = CreateCompatibleDC(
+			EngineHandle::get_handle().lock()->get_main_dc());
+		m_background_bitmap = CreateDIBSection(
+			m_background_hdc, &info, DIB_RGB_COLORS, reinterpret_cast<void**>(&m_background_bits), nullptr, 0);
+
+		const auto previousBackground = static_cast<HBITMAP>(SelectObject(m_background_hdc, m_background_bitmap));
+		DeleteObject(previousBackground);
+
+		std::fill_n(m_background_bits, static_cast<size_t>(m_width) * m_height, 0u);
+		// every ground is drawn again on the new background.
+		m_active_grounds.clear();
+
 		m_gdi_handle.reset(Graphics::FromHDC(m_radar_hdc));
 
 		m_bf.AlphaFormat = 0;
@@ -22,15 +51,49 @@ namespace Fortress
 		m_bf.SourceConstantAlpha = 127;
 	}
 
-	void Radar::update()
+	void Radar::release()
 	{
-		m_gdi_handle->Clear(Color(255, 0, 0, 0));
+		// graphics draws on the dc, and the bitmaps are not deleted while they are selected.
+		m_gdi_handle.reset();
+
+		if(m_radar_hdc)
+		{
+			DeleteDC(m_radar_hdc);
+			m_radar_hdc = nullptr;
+		}
+
+		if(m_radar_bitmap)
+		{
+			DeleteObject(m_radar_bitmap);
+			m_radar_bitmap = nullptr;
+		}
+
+		if(m_background_hdc)
+		{
+			DeleteDC(m_background_hdc);
+			m_background_hdc = nullptr;
+		}
+
+		if(m_background_bitmap)
+		{
+			DeleteObject(m_background_bitmap);
+			m_background_bitmap = nullptr;
+			m_background_bits = nullptr;
+		}
+	}
 
+	void Radar::update()
+	{
 		if(const auto scene = Scene::SceneManager::get_active_map().lock())
 		{
+			update_background(scene->get_grounds());
+
+			BitBlt(m_radar_hdc, 0, 0, m_width, m_height, m_background_hdc, 0, 0, SRCCOPY);
+
 			const auto green = SolidBrush(Color(255, 0, 255, 0));
+			constexpr float marker_size = 20.0f / radar_cell_size;
 
-			for(const auto& ptr : scene->get_grounds())
+			for(const auto& ptr : scene->get_objects<ObjectBase::character>(FrameArena::get_resource()))
 			{
 				if(const auto obj = ptr.lock())
 				{
@@ -40,50 +103,146 @@ namespace Fortress
 						continue;
 					}
 
-					const Math::Vector2 position = obj->get_top_left() + m_center + (radar_padding / 2);
+					const Math::Vector2 position = 
+						(obj->get_center() + m_center + (radar_padding / 2)) / static_cast<float>(radar_cell_size);
 
-					if(const auto gr = std::dynamic_pointer_cast<Object::Ground>(obj))
+					const auto rect = RectF
 					{
-						const auto bitmap = gr->get_mask_bitmap_copy();
+						position.get_x(),
+						position.get_y(),
+						marker_size,
+						marker_size
+					};
 
-						m_gdi_handle->DrawImage(
-							bitmap.get(),
-							position);
+					// skip the dead character to be rendered.
+					if(obj->get_state() == eCharacterState::Dead)
+					{
+						continue;
 					}
+
+					m_gdi_handle->FillRectangle(&green, rect);
 				}
 			}
+		}
+	}
+
+	void Radar::update_background(const std::vector<GroundPointer>& grounds)
+	{
+		bool rebuild = m_active_grounds.size() != grounds.size();
+		m_active_grounds.resize(grounds.size());
+
+		for(size_t i = 0; i < grounds.size(); ++i)
+		{
+			const auto gr = grounds[i].lock();
+			const bool active = gr && gr->is_active();
+
+			rebuild |= m_active_grounds[i] != active;
+			m_active_grounds[i] = active;
+		}
+
+		// the background memory is touched directly.
+		GdiFlush();
+
+		if(rebuild)
+		{
+			std::fill_n(m_background_bits, static_cast<size_t>(m_width) * m_height, 0u);
+		}
+
+		for(size_t i = 0; i < grounds.size(); ++i)
+		{
+			const auto gr = grounds[i].lock();
+
+			if(!gr)
+			{
+				continue;
+			}
+
+			gr->take_radar_dirty_regions(m_dirty_regions);
+
+			// we don't need the deactivated object to be rendered.
+			if(!m_active_grounds[i])
+			{
+				continue;
+			}
 
-			for(const auto& ptr : scene->get_characters())
+			if(rebuild)
 			{
-				if(const auto obj = ptr.lock())
+				patch_ground(*gr, {0, 0, gr->m_destroyed_table.get_width(), gr->m_destroyed_table.get_height()});
+				continue;
+			}
+
+			for(const auto& region : m_dirty_regions)
+			{
+				patch_ground(*gr, region);
+			}
+		}
+	}
+
+	void Radar::patch_ground(const Object::Ground& ground, const RECT& region)
+	{
+		const Object::GroundGrid& table = ground.m_destroyed_table;
+		const Math::Vector2 origin = 
+			(ground.get_top_left() + m_center + (radar_padding / 2)) / static_cast<float>(radar_cell_size);
+		const int origin_x = static_cast<int>(std::floor(origin.get_x()));
+		const int origin_y = static_cast<int>(std::floor(origin.get_y()));
+
+		const int first_x = (std::max)(static_cast<int>(region.left), 0) / radar_cell_size;
+		const int first_y = (std::max)(static_cast<int>(region.top), 0) / radar_cell_size;
+		const int last_x = ((std::min)(static_cast<int>(region.right), table.get_width()) - 1) / radar_cell_size;
+		const int last_y = ((std::min)(static_cast<int>(region.bottom), table.get_height()) - 1) / radar_cell_size;
+
+		for(int cy = first_y; cy <= last_y; ++cy)
+		{
+			const int radar_y = origin_y + cy;
+
+			if(radar_y < 0 || radar_y >= m_height)
+			{
+				continue;
+			}
+
+			for(int cx = first_x; cx <= last_x; ++cx)
+			{
+				const int radar_x = origin_x + cx;
+
+				if(radar_x < 0 || radar_x >= m_width)
 				{
-					// we don't need the deactivated object to be rendered.
-					if (!obj->is_active())
-					{
-						continue;
-					}
+					continue;
+				}
 
-					const Math::Vector2 position = obj->get_center() + m_center + (radar_padding / 2);
+				const int x = cx * radar_cell_size;
+				const int y = cy * radar_cell_size;
+				unsigned int level;
 
-					const auto rect = RectF
-					{
-						position.get_x(),
-						position.get_y(),
-						20,
-						20
-					};
+				if(table.is_block_empty(x, y))
+				{
+					level = 0;
+				}
+				else if(table.is_block_solid(x, y))
+				{
+					level = 255;
+				}
+				else
+				{
+					// partial block, ratio of the solid pixels in the table.
+					const int columns = (std::min)(radar_cell_size, table.get_width() - x);
+					const int rows = (std::min)(radar_cell_size, table.get_height() - y);
+					const Object::GroundWord mask = Object::GroundGrid::bit_range_mask(
+						Object::GroundGrid::to_bit_shift(x),
+						Object::GroundGrid::to_bit_shift(x) + columns * Object::ground_bits_per_pixel);
+					unsigned int solid = 0;
 
-					// skip the dead character to be rendered.
-					if(const auto ch = std::dynamic_pointer_cast<ObjectBase::character>(obj))
+					for(int r = 0; r < rows; ++r)
 					{
-						if(ch->get_state() == eCharacterState::Dead)
-						{
-							continue;
-						}
-
-						m_gdi_handle->FillRectangle(&green, rect);
+						const Object::GroundWord word = table.get_word(Object::GroundGrid::to_word_x(x), y + r);
+						solid += static_cast<unsigned int>(__popcnt64(
+							Object::GroundGrid::match_state(word, Object::GroundState::NotDestroyed) & mask));
 					}
+
+					level = solid * 255 / (columns * rows);
 				}
+
+				// 0x00RRGGBB, white for the ground as the mask.
+				m_background_bits[static_cast<size_t>(radar_y) * m_width + radar_x] = level << 16 | level << 8 | level;
 			}
 		}
 	}
@@ -99,8 +258,8 @@ namespace Fortress
 			m_radar_hdc,
 			0,
 			0,
-			m_map_size.get_x(),
-			m_map_size.get_y(),
+			m_width,
+			m_height,
 			m_bf);
 	}
 
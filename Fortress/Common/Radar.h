@@ -6,26 +6,49 @@
 namespace Fortress
 {
 	constexpr float radar_padding = 100.0f;
+	// a radar pixel covers a block of the ground.
+	constexpr int radar_cell_size = Object::ground_block_size;
 
 	class Radar
 	{
 	public:
-		Radar(const Math::Vector2& map_size) : m_center(map_size / 2), m_map_size(map_size + radar_padding)
+		Radar(const Math::Vector2& map_size) :
+			m_center(map_size / 2),
+			m_map_size(map_size + radar_padding),
+			m_width(static_cast<int>(std::ceil(m_map_size.get_x() / radar_cell_size))),
+			m_height(static_cast<int>(std::ceil(m_map_size.get_y() / radar_cell_size)))
 		{
 			initialize();
 		}
+		~Radar();
+		// the previous surfaces are released, so the radar can be initialized again.
 		void initialize();
 		void update();
 		void render() const;
 
 		HDC get_radar_hdc() const;
 	private:
+		// redraws every ground if the set of the active grounds has changed, otherwise only the written regions.
+		void update_background(const std::vector<GroundPointer>& grounds);
+		// box filter of the solid pixels, a radar pixel per 8x8 block.
+		void patch_ground(const Object::Ground& ground, const RECT& region);
+		void release();
+
 		Math::Vector2 m_center;
 		Math::Vector2 m_map_size;
+		int m_width;
+		int m_height;
 		BLENDFUNCTION m_bf;
 
-		HDC m_radar_hdc;
-		HBITMAP m_radar_bitmap;
+		// grounds only, markers are drawn over the copy of it.
+		HDC m_background_hdc = nullptr;
+		HBITMAP m_background_bitmap = nullptr;
+		unsigned int* m_background_bits = nullptr;
+		std::vector<bool> m_active_grounds;
+		std::vector<RECT> m_dirty_regions;
+
+		HDC m_radar_hdc = nullptr;
+		HBITMAP m_radar_bitmap = nullptr;
 
 		std::unique_ptr<Graphics> m_gdi_handle;
 	};
@@ -111,7 +111,7 @@ namespace Fortress
 
 	void Round::update()
 	{
-		Debug::Log(std::to_wstring(m_wind_affect));
+		Debug::Log(L"%f", m_wind_affect);
 
 		switch (m_state)
 		{
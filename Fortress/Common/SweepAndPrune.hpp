@@ -0,0 +1,409 @@
+#pragma once
+#ifndef SWEEPANDPRUNE_HPP
+#define SWEEPANDPRUNE_HPP
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "common.h"
+#include "object.hpp"
+#include "UniformGrid.hpp"
+
+namespace Fortress::Abstract
+{
+	enum class eContactEvent
+	{
+		Enter,
+		Stay,
+		Exit
+	};
+
+	// narrowphase of a body against the other, kept while the contact stays.
+	struct ContactCache
+	{
+		Math::Vector2 top_left;
+		Math::Vector2 bottom_right;
+		Math::Vector2 other_top_left;
+		Math::Vector2 other_bottom_right;
+		CollisionCode code = CollisionCode::None;
+		GlobalPosition point;
+		bool valid = false;
+	};
+
+	/**
+	 * \brief A broadphase that sorts the endpoints of the objects along x, and sweeps them for the overlapping pairs.
+	 * the endpoints are kept between the frames, so the insertion sort runs in nearly linear time while the objects
+	 * move a little per frame. the pairs are kept as the contacts, the ones that are new in this update are marked
+	 * as entered and the ones that are gone are given once as exited.
+	 */
+	class SweepAndPrune
+	{
+	public:
+		SweepAndPrune() = default;
+		SweepAndPrune& operator=(const SweepAndPrune& other) = default;
+		SweepAndPrune& operator=(SweepAndPrune&& other) = default;
+		SweepAndPrune(const SweepAndPrune& other) = default;
+		SweepAndPrune(SweepAndPrune&& other) = default;
+		~SweepAndPrune() = default;
+
+		// objects that are not given since the last update are removed.
+		void update(const std::vector<std::weak_ptr<object>>& objects);
+		void clear();
+
+		// calls function(const std::weak_ptr<object>&, eContactEvent, ContactCache&) for each contact of this update.
+		// the cache is the one of the body against the other, and an exited contact has the last one.
+		template <typename Function>
+		void for_each_contact(const object* obj, const Function& function) const;
+
+	private:
+		struct Body
+		{
+			std::weak_ptr<object> ptr;
+			const object* key = nullptr;
+			float top = 0.0f;
+			float bottom = 0.0f;
+			float left = 0.0f;
+			float right = 0.0f;
+			bool alive = false;
+			bool seen = false;
+		};
+
+		struct Endpoint
+		{
+			float value;
+			int body;
+			bool is_min;
+		};
+
+		struct Pair
+		{
+			int left;
+			int right;
+			bool entered;
+			// of the left against the right, and of the right against the left.
+			ContactCache cache[2];
+
+			bool operator<(const Pair& other) const
+			{
+				return left < other.left || (left == other.left && right < other.right);
+			}
+
+			bool operator==(const Pair& other) const
+			{
+				return left == other.left && right == other.right;
+			}
+		};
+
+		int add_body(const std::shared_ptr<object>& obj);
+		void remove_dead_bodies();
+		void sort_endpoints();
+		void sweep();
+		void diff_pairs();
+		void build_contacts();
+
+		static bool is_ordered(const Endpoint& left, const Endpoint& right);
+
+		std::vector<Body> m_bodies;
+		std::unordered_map<const object*, int> m_lookup;
+		// slots are reused from the next update, so that a removed pair is not taken as the stayed one.
+		std::vector<int> m_free_bodies;
+		std::vector<int> m_pending_free_bodies;
+
+		std::vector<Endpoint> m_endpoints;
+		std::vector<int> m_active;
+		std::vector<Pair> m_pairs;
+		std::vector<Pair> m_previous_pairs;
+		std::vector<Pair> m_exited_pairs;
+
+		struct Contact
+		{
+			int body;
+			eContactEvent event;
+			// points to the pairs of this update, which are not changed until the next one.
+			ContactCache* cache;
+		};
+
+		// contacts of the body i are m_contacts[m_offsets[i], m_offsets[i + 1]).
+		std::vector<int> m_offsets;
+		std::vector<int> m_cursors;
+		std::vector<Contact> m_contacts;
+	};
+
+	inline void SweepAndPrune::update(const std::vector<std::weak_ptr<object>>& objects)
+	{
+		for(Body& body : m_bodies)
+		{
+			body.seen = false;
+		}
+
+		for(const auto& obj : objects)
+		{
+			const auto ptr = obj.lock();
+
+			if(!ptr || !ptr->is_active())
+			{
+				continue;
+			}
+
+			const auto it = m_lookup.find(ptr.get());
+			// same address can be taken by the new object after the old one is released.
+			const int index = it != m_lookup.end() && m_bodies[it->second].ptr.lock() == ptr ?
+				it->second : add_body(ptr);
+
+			Body& body = m_bodies[index];
+			const Math::Vector2 top_left = ptr->get_top_left();
+			const Math::Vector2 bottom_right = ptr->get_bottom_right();
+
+			body.left = top_left.get_x() - broadphase_margin;
+			body.top = top_left.get_y() - broadphase_margin;
+			body.right = bottom_right.get_x() + broadphase_margin;
+			body.bottom = bottom_right.get_y() + broadphase_margin;
+			body.seen = true;
+		}
+
+		remove_dead_bodies();
+		sort_endpoints();
+		sweep();
+		diff_pairs();
+		build_contacts();
+
+		m_free_bodies.insert(m_free_bodies.end(), m_pending_free_bodies.begin(), m_pending_free_bodies.end());
+		m_pending_free_bodies.clear();
+	}
+
+	inline void SweepAndPrune::clear()
+	{
+		m_bodies.clear();
+		m_lookup.clear();
+		m_free_bodies.clear();
+		m_pending_free_bodies.clear();
+		m_endpoints.clear();
+		m_pairs.clear();
+		m_previous_pairs.clear();
+		m_exited_pairs.clear();
+		m_offsets.clear();
+		m_contacts.clear();
+	}
+
+	template <typename Function>
+	void SweepAndPrune::for_each_contact(const object* obj, const Function& function) const
+	{
+		const auto it = m_lookup.find(obj);
+
+		// added after the update of this frame.
+		if(it == m_lookup.end() || it->second + 1 >= static_cast<int>(m_offsets.size()))
+		{
+			return;
+		}
+
+		for(int i = m_offsets[it->second]; i < m_offsets[it->second + 1]; ++i)
+		{
+			const Contact& contact = m_contacts[i];
+			function(m_bodies[contact.body].ptr, contact.event, *contact.cache);
+		}
+	}
+
+	inline int SweepAndPrune::add_body(const std::shared_ptr<object>& obj)
+	{
+		int index;
+
+		if(!m_free_bodies.empty())
+		{
+			index = m_free_bodies.back();
+			m_free_bodies.pop_back();
+		}
+		else
+		{
+			index = static_cast<int>(m_bodies.size());
+			m_bodies.emplace_back();
+		}
+
+		Body& body = m_bodies[index];
+		body.ptr = obj;
+		body.key = obj.get();
+		body.alive = true;
+
+		m_lookup[body.key] = index;
+		// values are filled before the sort, the new endpoints are placed by it.
+		m_endpoints.push_back({0.0f, index, true});
+		m_endpoints.push_back({0.0f, index, false});
+
+		return index;
+	}
+
+	inline void SweepAndPrune::remove_dead_bodies()
+	{
+		bool removed = false;
+
+		for(int i = 0; i < static_cast<int>(m_bodies.size()); ++i)
+		{
+			Body& body = m_bodies[i];
+
+			if(!body.alive || body.seen)
+			{
+				continue;
+			}
+
+			if(const auto it = m_lookup.find(body.key); it != m_lookup.end() && it->second == i)
+			{
+				m_lookup.erase(it);
+			}
+
+			body.alive = false;
+			body.ptr.reset();
+			body.key = nullptr;
+			m_pending_free_bodies.push_back(i);
+			removed = true;
+		}
+
+		if(removed)
+		{
+			m_endpoints.erase(
+				std::remove_if(m_endpoints.begin(), m_endpoints.end(), [this](const Endpoint& endpoint)
+				{
+					return !m_bodies[endpoint.body].alive;
+				}),
+				m_endpoints.end());
+		}
+	}
+
+	inline void SweepAndPrune::sort_endpoints()
+	{
+		for(Endpoint& endpoint : m_endpoints)
+		{
+			const Body& body = m_bodies[endpoint.body];
+			endpoint.value = endpoint.is_min ? body.left : body.right;
+		}
+
+		// order of the last frame is mostly kept, only a few of the endpoints are shifted.
+		for(size_t i = 1; i < m_endpoints.size(); ++i)
+		{
+			const Endpoint key = m_endpoints[i];
+			size_t j = i;
+
+			while(j > 0 && is_ordered(key, m_endpoints[j - 1]))
+			{
+				m_endpoints[j] = m_endpoints[j - 1];
+				--j;
+			}
+
+			m_endpoints[j] = key;
+		}
+	}
+
+	inline void SweepAndPrune::sweep()
+	{
+		m_previous_pairs.swap(m_pairs);
+		m_pairs.clear();
+		m_active.clear();
+
+		for(const Endpoint& endpoint : m_endpoints)
+		{
+			if(!endpoint.is_min)
+			{
+				const auto it = std::find(m_active.begin(), m_active.end(), endpoint.body);
+
+				if(it != m_active.end())
+				{
+					*it = m_active.back();
+					m_active.pop_back();
+				}
+
+				continue;
+			}
+
+			const Body& body = m_bodies[endpoint.body];
+
+			// overlapped along x, y is checked for the pair.
+			for(const int other : m_active)
+			{
+				const Body& other_body = m_bodies[other];
+
+				if(body.top <= other_body.bottom && other_body.top <= body.bottom)
+				{
+					m_pairs.push_back(
+						{(std::min)(endpoint.body, other), (std::max)(endpoint.body, other), false});
+				}
+			}
+
+			m_active.push_back(endpoint.body);
+		}
+
+		std::sort(m_pairs.begin(), m_pairs.end());
+	}
+
+	inline void SweepAndPrune::diff_pairs()
+	{
+		m_exited_pairs.clear();
+
+		auto current = m_pairs.begin();
+		auto previous = m_previous_pairs.begin();
+
+		while(current != m_pairs.end() || previous != m_previous_pairs.end())
+		{
+			if(previous == m_previous_pairs.end() || (current != m_pairs.end() && *current < *previous))
+			{
+				current->entered = true;
+				++current;
+			}
+			else if(current == m_pairs.end() || *previous < *current)
+			{
+				m_exited_pairs.push_back(*previous);
+				++previous;
+			}
+			else
+			{
+				current->cache[0] = previous->cache[0];
+				current->cache[1] = previous->cache[1];
+				++current;
+				++previous;
+			}
+		}
+	}
+
+	inline void SweepAndPrune::build_contacts()
+	{
+		m_offsets.assign(m_bodies.size() + 1, 0);
+
+		for(const auto* pairs : {&m_pairs, &m_exited_pairs})
+		{
+			for(const Pair& pair : *pairs)
+			{
+				++m_offsets[pair.left + 1];
+				++m_offsets[pair.right + 1];
+			}
+		}
+
+		for(size_t i = 1; i < m_offsets.size(); ++i)
+		{
+			m_offsets[i] += m_offsets[i - 1];
+		}
+
+		m_cursors.assign(m_offsets.begin(), m_offsets.end() - 1);
+		m_contacts.resize(m_offsets.back());
+
+		for(Pair& pair : m_pairs)
+		{
+			const eContactEvent event = pair.entered ? eContactEvent::Enter : eContactEvent::Stay;
+
+			m_contacts[m_cursors[pair.left]++] = {pair.right, event, &pair.cache[0]};
+			m_contacts[m_cursors[pair.right]++] = {pair.left, event, &pair.cache[1]};
+		}
+
+		for(Pair& pair : m_exited_pairs)
+		{
+			m_contacts[m_cursors[pair.left]++] = {pair.right, eContactEvent::Exit, &pair.cache[0]};
+			m_contacts[m_cursors[pair.right]++] = {pair.left, eContactEvent::Exit, &pair.cache[1]};
+		}
+	}
+
+	inline bool SweepAndPrune::is_ordered(const Endpoint& left, const Endpoint& right)
+	{
+		// touching boxes are counted as the overlap, min comes before max.
+		return left.value < right.value || (left.value == right.value && left.is_min && !right.is_min);
+	}
+}
+
+#endif // SWEEPANDPRUNE_HPP
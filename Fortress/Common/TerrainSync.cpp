@@ -0,0 +1,259 @@
+#include "pch.h"
+#include "TerrainSync.h"
+
+#include "EngineHandle.h"
+
+#undef min
+#undef max
+
+namespace Fortress
+{
+	void TerrainSync::next_turn()
+	{
+		std::fill(m_replied_versions.begin(), m_replied_versions.end(), no_reply);
+	}
+
+	void TerrainSync::request(const Network::PlayerID authority) const
+	{
+		for(unsigned int i = 0; i < m_grounds.size(); ++i)
+		{
+			EngineHandle::get_messenger()->send_message<Network::TerrainDigestReqMsg>(
+				Network::eMessageType::TerrainDigestReq, Network::TerrainDigestReqMsg{{}, authority, i});
+		}
+	}
+
+	void TerrainSync::update()
+	{
+		const auto messenger = EngineHandle::get_messenger();
+
+		Network::TerrainDigestReqMsg digest_request{};
+
+		while(messenger->pop_peer_message<Network::TerrainDigestReqMsg>(
+			Network::eMessageType::TerrainDigestReq, &digest_request))
+		{
+			// the turn may have moved on when the request arrives, the shooter is named by the requester.
+			if(digest_request.target_player_id == messenger->get_player_id())
+			{
+				reply_digest(digest_request);
+			}
+		}
+
+		Network::TerrainChunkReqMsg chunk_request{};
+
+		while(messenger->pop_peer_message<Network::TerrainChunkReqMsg>(
+			Network::eMessageType::TerrainChunkReq, &chunk_request))
+		{
+			if(chunk_request.target_player_id == messenger->get_player_id())
+			{
+				reply_chunks(chunk_request);
+			}
+		}
+
+		Network::TerrainDigestMsg digest{};
+
+		while(messenger->pop_peer_message<Network::TerrainDigestMsg>(
+			Network::eMessageType::TerrainDigest, &digest))
+		{
+			compare_digest(digest);
+		}
+
+		Network::TerrainChunkMsg chunks{};
+
+		while(messenger->pop_peer_message<Network::TerrainChunkMsg>(
+			Network::eMessageType::TerrainChunk, &chunks))
+		{
+			apply_chunks(chunks);
+		}
+	}
+
+	void TerrainSync::reply_digest(const Network::TerrainDigestReqMsg& request)
+	{
+		const auto ground = get_ground(request.ground_index);
+
+		if(!ground)
+		{
+			return;
+		}
+
+		const int total = ground->get_chunk_count();
+		const uint64_t version = ground->safe_get_version();
+
+		// the other requesters have received the same digests already.
+		if(m_replied_versions[request.ground_index] == version)
+		{
+			return;
+		}
+
+		m_replied_versions[request.ground_index] = version;
+
+		for(int first = 0; first < total; first += Network::terrain_digest_chunks)
+		{
+			Network::TerrainDigestMsg digest{};
+			digest.ground_index = request.ground_index;
+			digest.version = version;
+			digest.total_chunks = total;
+			digest.first_chunk = first;
+			digest.chunk_count = std::min(Network::terrain_digest_chunks, total - first);
+
+			for(int i = 0; i < digest.chunk_count; ++i)
+			{
+				digest.chunk_crc[i] = ground->safe_get_chunk_checksum(first + i);
+			}
+
+			EngineHandle::get_messenger()->send_message<Network::TerrainDigestMsg>(
+				Network::eMessageType::TerrainDigest, digest);
+		}
+	}
+
+	void TerrainSync::reply_chunks(const Network::TerrainChunkReqMsg& request) const
+	{
+		const auto ground = get_ground(request.ground_index);
+
+		if(!ground)
+		{
+			return;
+		}
+
+		Network::TerrainChunkMsg chunks{};
+		chunks.ground_index = request.ground_index;
+		chunks.version = ground->safe_get_version();
+
+		uint8_t encoded[Object::ground_chunk_encoded_max];
+
+		for(int i = 0; i < Network::terrain_digest_chunks; ++i)
+		{
+			const int index = request.first_chunk + i;
+
+			if(index >= ground->get_chunk_count())
+			{
+				break;
+			}
+
+			if(!(request.requested[i / 8] & (1 << (i % 8))))
+			{
+				continue;
+			}
+
+			Object::GroundChunkEncoding encoding;
+			const size_t size = ground->safe_encode_chunk(index, encoding, encoded);
+
+			// packs as many chunks as the datagram can take.
+			if(chunks.payload_size + Network::terrain_chunk_header_size + size > Network::terrain_payload_size)
+			{
+				EngineHandle::get_messenger()->send_message<Network::TerrainChunkMsg>(
+					Network::eMessageType::TerrainChunk, chunks);
+				chunks.chunk_count = 0;
+				chunks.payload_size = 0;
+			}
+
+			uint8_t* header = chunks.payload + chunks.payload_size;
+			header[0] = static_cast<uint8_t>(index & 0xff);
+			header[1] = static_cast<uint8_t>(index >> 8);
+			header[2] = static_cast<uint8_t>(encoding);
+			header[3] = static_cast<uint8_t>(size & 0xff);
+			header[4] = static_cast<uint8_t>(size >> 8);
+			std::memcpy(header + Network::terrain_chunk_header_size, encoded, size);
+
+			chunks.payload_size += static_cast<uint16_t>(Network::terrain_chunk_header_size + size);
+			++chunks.chunk_count;
+		}
+
+		if(chunks.chunk_count != 0)
+		{
+			EngineHandle::get_messenger()->send_message<Network::TerrainChunkMsg>(
+				Network::eMessageType::TerrainChunk, chunks);
+		}
+	}
+
+	void TerrainSync::compare_digest(const Network::TerrainDigestMsg& digest)
+	{
+		const auto ground = get_ground(digest.ground_index);
+
+		if(!ground || digest.total_chunks != ground->get_chunk_count() ||
+			digest.first_chunk < 0 || digest.chunk_count > Network::terrain_digest_chunks ||
+			digest.first_chunk + digest.chunk_count > digest.total_chunks)
+		{
+			return;
+		}
+
+		auto& expected = m_expected_checksums[digest.ground_index];
+		expected.resize(digest.total_chunks);
+		m_expected_versions[digest.ground_index] = digest.version;
+
+		Network::TerrainChunkReqMsg request{};
+		request.target_player_id = digest.player_id;
+		request.ground_index = digest.ground_index;
+		request.version = digest.version;
+		request.first_chunk = digest.first_chunk;
+		bool differs = false;
+
+		for(int i = 0; i < digest.chunk_count; ++i)
+		{
+			const int index = digest.first_chunk + i;
+			expected[index] = digest.chunk_crc[i];
+
+			if(ground->safe_get_chunk_checksum(index) != digest.chunk_crc[i])
+			{
+				request.requested[i / 8] |= static_cast<uint8_t>(1 << (i % 8));
+				differs = true;
+			}
+		}
+
+		if(differs)
+		{
+			EngineHandle::get_messenger()->send_message<Network::TerrainChunkReqMsg>(
+				Network::eMessageType::TerrainChunkReq, request);
+		}
+	}
+
+	void TerrainSync::apply_chunks(const Network::TerrainChunkMsg& chunks) const
+	{
+		const auto ground = get_ground(chunks.ground_index);
+
+		// chunks from the other version do not match the checksums we have.
+		if(!ground || chunks.version != m_expected_versions[chunks.ground_index] ||
+			chunks.payload_size > Network::terrain_payload_size)
+		{
+			return;
+		}
+
+		const auto& expected = m_expected_checksums[chunks.ground_index];
+		int offset = 0;
+
+		for(int n = 0; n < chunks.chunk_count; ++n)
+		{
+			if(offset + Network::terrain_chunk_header_size > chunks.payload_size)
+			{
+				break;
+			}
+
+			const uint8_t* header = chunks.payload + offset;
+			const int index = header[0] | (header[1] << 8);
+			const auto encoding = static_cast<Object::GroundChunkEncoding>(header[2]);
+			const int size = header[3] | (header[4] << 8);
+			const int data_offset = offset + Network::terrain_chunk_header_size;
+
+			if(data_offset + size > chunks.payload_size)
+			{
+				break;
+			}
+
+			if(index < static_cast<int>(expected.size()))
+			{
+				ground->safe_apply_chunk(index, encoding, chunks.payload + data_offset, size, expected[index]);
+			}
+
+			offset = data_offset + size;
+		}
+	}
+
+	std::shared_ptr<Object::Ground> TerrainSync::get_ground(const unsigned int index) const
+	{
+		if(index >= m_grounds.size())
+		{
+			return nullptr;
+		}
+
+		return m_grounds[index].lock();
+	}
+}
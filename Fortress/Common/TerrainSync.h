@@ -0,0 +1,48 @@
+#ifndef TERRAINSYNC_HPP
+#define TERRAINSYNC_HPP
+
+#include "ground.hpp"
+#include "message.hpp"
+
+namespace Fortress
+{
+	/**
+	 * \brief Repairs the diverged terrain from a peer. requester asks the authority for the digests,
+	 * compares the chunk checksums and pulls only the chunks that differ.
+	 */
+	class TerrainSync
+	{
+	public:
+		TerrainSync(const std::vector<GroundPointer>& grounds) :
+			m_grounds(grounds),
+			m_expected_versions(grounds.size(), 0),
+			m_expected_checksums(grounds.size()),
+			m_replied_versions(grounds.size(), no_reply)
+		{
+		}
+
+		// every peer asks the authority after the turn, which answers the first request of each version only.
+		void next_turn();
+		// asks the authority for the digests of every ground.
+		void request(Network::PlayerID authority) const;
+		// every peer answers the digest and chunk requests targeting itself.
+		void update();
+
+	private:
+		void reply_digest(const Network::TerrainDigestReqMsg& request);
+		void reply_chunks(const Network::TerrainChunkReqMsg& request) const;
+		void compare_digest(const Network::TerrainDigestMsg& digest);
+		void apply_chunks(const Network::TerrainChunkMsg& chunks) const;
+		std::shared_ptr<Object::Ground> get_ground(const unsigned int index) const;
+
+		std::vector<GroundPointer> m_grounds;
+		// chunks are verified against the last digest of the ground.
+		std::vector<uint64_t> m_expected_versions;
+		std::vector<std::vector<Network::CRC32>> m_expected_checksums;
+
+		static constexpr uint64_t no_reply = UINT64_MAX;
+		// digests are broadcast, so one reply of the version in the turn reaches every requester.
+		std::vector<uint64_t> m_replied_versions;
+	};
+}
+#endif // TERRAINSYNC_HPP
@@ -0,0 +1,222 @@
+#pragma once
+#ifndef TRAJECTORYPREDICTOR_HPP
+#define TRAJECTORYPREDICTOR_HPP
+
+#include <algorithm>
+#include <cmath>
+
+#include "math.h"
+#include "vector2.hpp"
+
+namespace Fortress::ObjectBase
+{
+	// chord length of the march against the ground, in pixel.
+	constexpr float trajectory_march_step = 8.0f;
+	constexpr float trajectory_max_time = 30.0f;
+
+	/**
+	 * \brief Closed form of the projectile flight. the speed of the projectile is scaled by the velocity per axis,
+	 * the wind is added to the speed along x and the gravity is added to the position along y, all of them are
+	 * constant while flying.
+	 *
+	 * p(t) = p0 + v * s * t + 0.5 * a * t^2, where a.x = v.x * acc.x + |v.x| * wind and a.y = v.y * acc.y + gravity.
+	 */
+	class TrajectoryPredictor
+	{
+	public:
+		TrajectoryPredictor(
+			const GlobalPosition& origin,
+			const UnitVector& velocity,
+			const SpeedVector& speed,
+			const AccelVector& acceleration,
+			const float wind,
+			const float gravity = Math::G_ACC) :
+			m_origin(origin),
+			m_initial_velocity(velocity * speed),
+			m_acceleration{
+				velocity.get_x() * acceleration.get_x() + std::fabs(velocity.get_x()) * wind,
+				velocity.get_y() * acceleration.get_y() + gravity}
+		{
+		}
+
+		GlobalPosition get_position(const float time) const
+		{
+			return m_origin + m_initial_velocity * time + m_acceleration * (0.5f * time * time);
+		}
+
+		Math::Vector2 get_velocity(const float time) const
+		{
+			return m_initial_velocity + m_acceleration * time;
+		}
+
+		// time of the highest point, zero if it is already falling.
+		float get_apex_time() const
+		{
+			if(m_acceleration.get_y() <= 0.0f)
+			{
+				return 0.0f;
+			}
+
+			return (std::max)(-m_initial_velocity.get_y() / m_acceleration.get_y(), 0.0f);
+		}
+
+		GlobalPosition get_apex() const
+		{
+			return get_position(get_apex_time());
+		}
+
+		// the latest time that reaches y, which is the descending side. false if it never reaches.
+		bool get_time_to_y(const float y, float& time) const
+		{
+			return solve(m_acceleration.get_y() * 0.5f, m_initial_velocity.get_y(), m_origin.get_y() - y, time);
+		}
+
+		bool get_time_to_x(const float x, float& time) const
+		{
+			return solve(m_acceleration.get_x() * 0.5f, m_initial_velocity.get_x(), m_origin.get_x() - x, time);
+		}
+
+		/**
+		 * \brief Marches the curve in chords and finds the first hit.
+		 * \param ray_cast GlobalPosition(const GlobalPosition& from, const GlobalPosition& to), returns the first
+		 * solid point between them or Math::vector_inf.
+		 * \return false if nothing is hit until max_time.
+		 */
+		template <typename Function>
+		bool find_first_hit(const Function& ray_cast, GlobalPosition& hit, float& hit_time, const float max_time = trajectory_max_time) const
+		{
+			float time = 0.0f;
+			GlobalPosition from = m_origin;
+
+			while(time < max_time)
+			{
+				const float next_time = (std::min)(time + get_march_step(time), max_time);
+				const GlobalPosition to = get_position(next_time);
+				const GlobalPosition candidate = ray_cast(from, to);
+
+				if(candidate != Math::vector_inf)
+				{
+					const float chord = (to - from).magnitude();
+					const float ratio = chord > 0.0f ? (candidate - from).magnitude() / chord : 0.0f;
+
+					hit = candidate;
+					hit_time = time + (next_time - time) * ratio;
+					return true;
+				}
+
+				time = next_time;
+				from = to;
+			}
+
+			return false;
+		}
+
+		// distance between the point and the nearest point of the curve in [0, max_time].
+		float get_distance(const GlobalPosition& point, const float max_time = trajectory_max_time) const
+		{
+			float nearest_time;
+			return get_distance(point, nearest_time, max_time);
+		}
+
+		// nearest_time is the time of the nearest point.
+		float get_distance(const GlobalPosition& point, float& nearest_time, const float max_time = trajectory_max_time) const
+		{
+			nearest_time = 0.0f;
+			float nearest = (get_position(0.0f) - point).magnitude();
+
+			for(float time = 0.0f; time < max_time;)
+			{
+				time = (std::min)(time + get_march_step(time), max_time);
+				const float distance = (get_position(time) - point).magnitude();
+
+				if(distance < nearest)
+				{
+					nearest = distance;
+					nearest_time = time;
+				}
+			}
+
+			// the chord is short, refine around the nearest sample.
+			float low = (std::max)(nearest_time - get_march_step(nearest_time), 0.0f);
+			float high = (std::min)(nearest_time + get_march_step(nearest_time), max_time);
+
+			for(int i = 0; i < 16; ++i)
+			{
+				const float left = low + (high - low) / 3.0f;
+				const float right = high - (high - low) / 3.0f;
+
+				if((get_position(left) - point).magnitude() < (get_position(right) - point).magnitude())
+				{
+					high = right;
+				}
+				else
+				{
+					low = left;
+				}
+			}
+
+			const float refined_time = (low + high) / 2.0f;
+			const float refined = (get_position(refined_time) - point).magnitude();
+
+			if(refined < nearest)
+			{
+				nearest_time = refined_time;
+				return refined;
+			}
+
+			return nearest;
+		}
+
+		// the horizontal flight turns back before the time, e.g. against the headwind.
+		bool is_reversed_before(const float time) const
+		{
+			return m_initial_velocity.get_x() * get_velocity(time).get_x() < 0.0f;
+		}
+
+	private:
+		float get_march_step(const float time) const
+		{
+			const float speed = get_velocity(time).magnitude();
+			return speed > Math::epsilon ? trajectory_march_step / speed : trajectory_max_time;
+		}
+
+		// latest non-negative root of a * t^2 + b * t + c = 0.
+		static bool solve(const float a, const float b, const float c, float& time)
+		{
+			if(std::fabs(a) <= Math::epsilon)
+			{
+				if(std::fabs(b) <= Math::epsilon)
+				{
+					return false;
+				}
+
+				time = -c / b;
+				return time >= 0.0f;
+			}
+
+			const float discriminant = b * b - 4.0f * a * c;
+
+			if(discriminant < 0.0f)
+			{
+				return false;
+			}
+
+			const float root = std::sqrt(discriminant);
+			const float later = (std::max)((-b + root) / (2.0f * a), (-b - root) / (2.0f * a));
+
+			if(later < 0.0f)
+			{
+				return false;
+			}
+
+			time = later;
+			return true;
+		}
+
+		GlobalPosition m_origin;
+		Math::Vector2 m_initial_velocity;
+		Math::Vector2 m_acceleration;
+	};
+}
+
+#endif // TRAJECTORYPREDICTOR_HPP
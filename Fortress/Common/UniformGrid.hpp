@@ -0,0 +1,208 @@
+#pragma once
+#ifndef UNIFORMGRID_HPP
+#define UNIFORMGRID_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "object.hpp"
+
+namespace Fortress::Abstract
+{
+	constexpr float broadphase_cell_size = 128.0f;
+	// objects move after the grid is built, boxes are fattened to keep the candidates valid within the frame.
+	constexpr float broadphase_margin = 32.0f;
+
+	/**
+	 * \brief A broadphase that buckets the objects into the uniform cells by their hitbox. it is rebuilt once
+	 * per frame, and answers the range queries. the pairs of the narrowphase are from the sweep and prune.
+	 */
+	class UniformGrid
+	{
+	public:
+		UniformGrid() = default;
+		UniformGrid& operator=(const UniformGrid& other) = default;
+		UniformGrid& operator=(UniformGrid&& other) = default;
+		UniformGrid(const UniformGrid& other) = default;
+		UniformGrid(UniformGrid&& other) = default;
+		~UniformGrid() = default;
+
+		void clear();
+		void insert(const std::shared_ptr<object>& obj);
+		// sorts the cells for the lookup, should be called after the insertions.
+		void build();
+
+		// calls function(const std::weak_ptr<object>&) once for each object of the tag whose fattened box overlaps
+		// the box, any tag if it is None. not for the concurrent queries.
+		template <typename Function>
+		void for_each_overlap(
+			const Math::Vector2& top_left,
+			const Math::Vector2& bottom_right,
+			eObjectTag tag,
+			const Function& function) const;
+
+	private:
+		struct Entry
+		{
+			std::weak_ptr<object> ptr;
+			eObjectTag tag;
+			float left;
+			float top;
+			float right;
+			float bottom;
+		};
+
+		struct CellRecord
+		{
+			int64_t cell;
+			int entry;
+		};
+
+		static int64_t to_cell_key(const int x, const int y);
+		static bool is_overlapping(const Entry& left, const Entry& right);
+
+		std::vector<Entry> m_entries;
+		std::vector<CellRecord> m_cells;
+		// entries visited by the query of the same number are skipped.
+		mutable std::vector<unsigned int> m_visited;
+		mutable unsigned int m_query = 0;
+	};
+
+	inline void UniformGrid::clear()
+	{
+		m_entries.clear();
+		m_cells.clear();
+	}
+
+	inline void UniformGrid::insert(const std::shared_ptr<object>& obj)
+	{
+		const Math::Vector2 top_left = obj->get_top_left();
+		const Math::Vector2 bottom_right = obj->get_bottom_right();
+		const int index = static_cast<int>(m_entries.size());
+
+		m_entries.push_back(
+			{
+				obj,
+				obj->get_object_tag(),
+				top_left.get_x() - broadphase_margin,
+				top_left.get_y() - broadphase_margin,
+				bottom_right.get_x() + broadphase_margin,
+				bottom_right.get_y() + broadphase_margin
+			});
+
+		const Entry& entry = m_entries.back();
+		const int first_x = static_cast<int>(std::floor(entry.left / broadphase_cell_size));
+		const int first_y = static_cast<int>(std::floor(entry.top / broadphase_cell_size));
+		const int last_x = static_cast<int>(std::floor(entry.right / broadphase_cell_size));
+		const int last_y = static_cast<int>(std::floor(entry.bottom / broadphase_cell_size));
+
+		for(int y = first_y; y <= last_y; ++y)
+		{
+			for(int x = first_x; x <= last_x; ++x)
+			{
+				m_cells.push_back({to_cell_key(x, y), index});
+			}
+		}
+	}
+
+	inline void UniformGrid::build()
+	{
+		std::sort(m_cells.begin(), m_cells.end(), [](const CellRecord& left, const CellRecord& right)
+		{
+			return left.cell < right.cell || (left.cell == right.cell && left.entry < right.entry);
+		});
+
+		m_visited.assign(m_entries.size(), 0);
+		m_query = 0;
+	}
+
+	template <typename Function>
+	void UniformGrid::for_each_overlap(
+		const Math::Vector2& top_left,
+		const Math::Vector2& bottom_right,
+		const eObjectTag tag,
+		const Function& function) const
+	{
+		if(m_visited.size() != m_entries.size())
+		{
+			// inserted without the build.
+			return;
+		}
+
+		if(++m_query == 0)
+		{
+			std::fill(m_visited.begin(), m_visited.end(), 0);
+			m_query = 1;
+		}
+
+		const Entry query{{}, tag, top_left.get_x(), top_left.get_y(), bottom_right.get_x(), bottom_right.get_y()};
+		const auto visit = [&](const int index)
+		{
+			const Entry& entry = m_entries[index];
+
+			if(m_visited[index] == m_query || (tag != eObjectTag::None && entry.tag != tag))
+			{
+				return;
+			}
+
+			m_visited[index] = m_query;
+
+			if(is_overlapping(entry, query))
+			{
+				function(entry.ptr);
+			}
+		};
+
+		const int first_x = static_cast<int>(std::floor(query.left / broadphase_cell_size));
+		const int first_y = static_cast<int>(std::floor(query.top / broadphase_cell_size));
+		const int last_x = static_cast<int>(std::floor(query.right / broadphase_cell_size));
+		const int last_y = static_cast<int>(std::floor(query.bottom / broadphase_cell_size));
+		const double cell_count = (static_cast<double>(last_x) - first_x + 1) * (static_cast<double>(last_y) - first_y + 1);
+
+		// box larger than the occupied cells is cheaper to check entry by entry.
+		if(cell_count > static_cast<double>(m_cells.size()))
+		{
+			for(int i = 0; i < static_cast<int>(m_entries.size()); ++i)
+			{
+				visit(i);
+			}
+
+			return;
+		}
+
+		for(int y = first_y; y <= last_y; ++y)
+		{
+			for(int x = first_x; x <= last_x; ++x)
+			{
+				const int64_t key = to_cell_key(x, y);
+				auto it = std::lower_bound(
+					m_cells.begin(), m_cells.end(), key,
+					[](const CellRecord& record, const int64_t cell)
+					{
+						return record.cell < cell;
+					});
+
+				for(; it != m_cells.end() && it->cell == key; ++it)
+				{
+					visit(it->entry);
+				}
+			}
+		}
+	}
+
+	inline int64_t UniformGrid::to_cell_key(const int x, const int y)
+	{
+		return (static_cast<int64_t>(y) << 32) | static_cast<uint32_t>(x);
+	}
+
+	inline bool UniformGrid::is_overlapping(const Entry& left, const Entry& right)
+	{
+		return left.left <= right.right && right.left <= left.right &&
+			left.top <= right.bottom && right.top <= left.bottom;
+	}
+}
+
+#endif // UNIFORMGRID_HPP
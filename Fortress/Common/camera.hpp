@@ -1,8 +1,10 @@
 #pragma once
 #ifndef CAMERA_HPP
 #define CAMERA_HPP
+#include "deltatime.hpp"
 #include "EngineHandle.h"
 #include "object.hpp"
+#include "objectManager.hpp"
 #include "vector2.hpp"
 
 namespace Fortress
@@ -14,6 +16,7 @@ namespace Fortress
 		void initialize();
 		void set_object(const std::weak_ptr<Abstract::object>& obj);
 		Math::Vector2 get_relative_position(const std::weak_ptr<Abstract::object>& obj) const;
+		Math::Vector2 get_relative_point(const Math::Vector2& point) const;
 		Math::Vector2 get_offset() const;
 		Math::Vector2 get_offset(const Math::Vector2& hitbox) const;
 		std::weak_ptr<Abstract::object> get_locked_object() const;
@@ -23,13 +26,17 @@ namespace Fortress
 		Math::Vector2 m_window_size = {};
 		Math::Vector2 m_center_position = {};
 		std::weak_ptr<Abstract::object> m_lock_target;
+		// looked up without locking, the target from the outside of the object manager uses the pointer.
+		Abstract::ObjectHandle m_lock_handle;
+
+		const Abstract::object* get_lock_target() const;
 	};
 
 	inline void Camera::update()
 	{
 		m_center_position = m_window_size / 2;
 
-		if(const auto target_ptr = m_lock_target.lock())
+		if(const auto target_ptr = get_lock_target())
 		{
 			m_target_center = target_ptr->get_center();
 		}
@@ -43,17 +50,33 @@ namespace Fortress
 
 		m_center_position = m_window_size / 2;
 		m_lock_target.reset();
+		m_lock_handle = {};
 	}
 
 	inline void Camera::set_object(const std::weak_ptr<Abstract::object>& obj)
 	{
 		m_lock_target = obj;
+		m_lock_handle = {};
+
+		if(const auto ptr = obj.lock())
+		{
+			m_lock_handle = ptr->get_handle();
+		}
 	}
 
 	inline Math::Vector2 Camera::get_relative_position(const std::weak_ptr<Abstract::object>& obj) const
 	{
-		const auto diff = m_target_center - obj.lock()->get_center();
-		return (m_center_position - diff) - (obj.lock()->m_hitbox / 2);
+		// drawn between the last two physics steps.
+		const auto ptr = obj.lock();
+		return get_relative_point(ptr->get_interpolated_center(DeltaTime::get_alpha())) - (ptr->m_hitbox / 2);
+	}
+
+	inline Math::Vector2 Camera::get_relative_point(const Math::Vector2& point) const
+	{
+		const auto target_ptr = get_lock_target();
+		const auto target_center = target_ptr ?
+			target_ptr->get_interpolated_center(DeltaTime::get_alpha()) : m_target_center;
+		return m_center_position - (target_center - point);
 	}
 
 	inline Math::Vector2 Camera::get_offset() const
@@ -70,5 +93,15 @@ namespace Fortress
 	{
 		return m_lock_target;
 	}
+
+	inline const Abstract::object* Camera::get_lock_target() const
+	{
+		if(m_lock_handle.is_valid())
+		{
+			return ObjectBase::ObjectManager::find(m_lock_handle);
+		}
+
+		return m_lock_target.lock().get();
+	}
 }
 #endif // CAMERA_HPP
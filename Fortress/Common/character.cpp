@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "character.hpp"
 
+#include <algorithm>
+
 #include "ground.hpp"
 #include "projectile.hpp"
 #include "ProjectileController.hpp"
@@ -15,6 +17,14 @@ namespace Fortress::ObjectBase
 	character::~character()
 	{
 		TimerManager::remove(m_multi_projectile_timer);
+
+		for(const auto& pool : m_projectile_pool)
+		{
+			for(const auto& prj : pool)
+			{
+				ObjectManager::remove_object(prj);
+			}
+		}
 	}
 
 	void character::initialize()
@@ -27,10 +37,16 @@ namespace Fortress::ObjectBase
 
 	void character::update()
 	{
+		// collisions of this frame are handled after every layer is updated, the controller sees the last frame's.
 		rigidBody::update();
 		CharacterController::update();
 	}
 
+	Abstract::eObjectTag character::get_object_tag() const
+	{
+		return object_tag;
+	}
+
 	void character::prerender()
 	{
 		rigidBody::prerender();
@@ -52,17 +68,7 @@ namespace Fortress::ObjectBase
 			charged = 10.0f;
 		}
 
-		Math::Vector2 angle{};
-
-		if(get_offset() == Math::left)
-		{
-			angle = {-cosf(get_movement_pitch_radian()), -sinf(get_movement_pitch_radian())};
-		}
-		else
-		{
-			angle = {cosf(get_movement_pitch_radian()), sinf(get_movement_pitch_radian())};
-		}
-
+		const Math::Vector2 angle = get_fire_angle(get_movement_pitch_radian());
 		const std::weak_ptr<projectile> instantiated = initialize_projectile(0, angle, charged);
 
 		const int remaining = instantiated.lock()->get_fire_count() - 1;
@@ -172,41 +178,130 @@ namespace Fortress::ObjectBase
 
 	ProjectilePointer character::initialize_projectile(const unsigned int id, const Math::Vector2& angle, const float charged)
 	{
-		std::weak_ptr<projectile> instantiated;
+		const std::weak_ptr<projectile> instantiated = acquire_projectile(get_projectile_type(), id);
+		const auto projectile = instantiated.lock();
 
-		if(get_projectile_type() == eProjectileType::Main)
-		{
-			instantiated = get_main_projectile(id);
-		}
-		else if(get_projectile_type() == eProjectileType::Sub)
+		projectile->fire(
+			get_fire_position(projectile->m_hitbox, get_movement_pitch_radian()), 
+			angle, 
+			charged);
+
+		if(const auto scene = Scene::SceneManager::get_active_scene().lock())
 		{
-			instantiated = get_sub_projectile(id);
+			scene->add_game_object(Abstract::LayerType::Projectile, projectile);
 		}
-		else
+
+		add_active_projectile(projectile);
+
+		return instantiated;
+	}
+
+	UnitVector character::get_fire_angle(const float pitch) const
+	{
+		if(get_offset() == Math::left)
 		{
-			instantiated = get_nutshell_projectile();
+			return {-cosf(pitch), -sinf(pitch)};
 		}
 
-		const auto projectile = instantiated.lock();
+		return {cosf(pitch), sinf(pitch)};
+	}
 
+	GlobalPosition character::get_fire_position(const Math::Vector2& projectile_hitbox, const float pitch) const
+	{
 		// thinking as virtual circle which has an radius of projectile size + half of character hitbox,
 		// with an top left/right toward to.
-		const auto forward = Math::Vector2{get_offset().get_x(), -1} * (projectile->m_hitbox);
-		const auto forward_rotation = forward.rotate(get_movement_pitch_radian());
+		const auto forward = Math::Vector2{get_offset().get_x(), -1} * projectile_hitbox;
+		const auto forward_rotation = forward.rotate(pitch);
 
-		projectile->fire(
-			get_offset_top_forward_position() + forward_rotation, 
-			angle, 
-			charged);
+		return get_offset_top_forward_position() + forward_rotation;
+	}
 
-		if(const auto scene = Scene::SceneManager::get_active_scene().lock())
+	void character::prewarm_projectiles()
+	{
+		for(const auto type : {eProjectileType::Main, eProjectileType::Sub, eProjectileType::Nutshell})
 		{
-			scene->add_game_object(Abstract::LayerType::Projectile, projectile);
+			auto& pool = m_projectile_pool[static_cast<size_t>(type)];
+
+			if(pool.empty())
+			{
+				pool.push_back(create_projectile(type, 0));
+			}
+
+			// multiple shots of a fire are flying together.
+			const int fire_count = pool.front().lock()->get_fire_count();
+
+			while(static_cast<int>(pool.size()) < fire_count)
+			{
+				pool.push_back(create_projectile(type, static_cast<unsigned int>(pool.size())));
+			}
 		}
+	}
 
-		add_active_projectile(projectile);
+	ProjectilePointer character::acquire_projectile(const eProjectileType type, const unsigned int id)
+	{
+		auto& pool = m_projectile_pool[static_cast<size_t>(type)];
+		const auto& flying = get_projectiles();
 
-		return instantiated;
+		for(const auto& prj : pool)
+		{
+			const auto ptr = prj.lock();
+
+			if(!ptr)
+			{
+				continue;
+			}
+
+			const bool is_flying = std::any_of(flying.begin(), flying.end(), [&ptr](const ProjectilePointer& other)
+			{
+				return other.lock() == ptr;
+			});
+
+			if(!is_flying)
+			{
+				ptr->reset(id);
+				return ptr;
+			}
+		}
+
+		pool.erase(
+			std::remove_if(pool.begin(), pool.end(), [](const ProjectilePointer& prj)
+			{
+				return prj.expired();
+			}),
+			pool.end());
+		pool.push_back(create_projectile(type, id));
+
+		return pool.back();
+	}
+
+	ProjectilePointer character::create_projectile(const eProjectileType type, const unsigned int id)
+	{
+		switch(type)
+		{
+		case eProjectileType::Main:
+			return get_main_projectile(id);
+		case eProjectileType::Sub:
+			return get_sub_projectile(id);
+		case eProjectileType::Nutshell:
+		default:
+			return get_nutshell_projectile();
+		}
+	}
+
+	TrajectoryPredictor character::predict_fire(
+		const SpeedVector& speed,
+		const Math::Vector2& projectile_hitbox,
+		const float charged,
+		const float wind) const
+	{
+		// same as the projectile::fire.
+		return {
+			get_fire_position(projectile_hitbox, get_movement_pitch_radian()),
+			get_fire_angle(get_movement_pitch_radian()),
+			speed * charged,
+			{},
+			wind
+		};
 	}
 
 	character::character(
@@ -2,6 +2,8 @@
 #ifndef CHARACTER_HPP
 #define CHARACTER_HPP
 
+#include <array>
+
 #include "CharacterController.hpp"
 #include "rigidBody.hpp"
 #include "common.h"
@@ -9,6 +11,7 @@
 #include "Texture.hpp"
 #include "common.h"
 #include "ProjectileTimer.hpp"
+#include "TrajectoryPredictor.hpp"
 
 // forward declaration for avoiding circular reference
 namespace Fortress
@@ -31,6 +34,8 @@ namespace Fortress::ObjectBase
 	class character : public Abstract::rigidBody, public Controller::CharacterController
 	{
 	public:
+		static constexpr Abstract::eObjectTag object_tag = Abstract::eObjectTag::Character;
+
 		character() = delete;
 		character& operator=(const character& other) = default;
 		character& operator=(character&& other) = default;
@@ -40,6 +45,7 @@ namespace Fortress::ObjectBase
 
 		void initialize() override;
 		void update() override;
+		Abstract::eObjectTag get_object_tag() const override;
 		void render() override;
 		void prerender() override;
 
@@ -56,7 +62,19 @@ namespace Fortress::ObjectBase
 
 		float get_armor() const;
 		Network::PlayerID get_player_id() const;
+
+		// launch of the shot in the pitch, toward the current offset.
+		UnitVector get_fire_angle(const float pitch) const;
+		GlobalPosition get_fire_position(const Math::Vector2& projectile_hitbox, const float pitch) const;
+		// flight of the shot in the current pitch, without firing.
+		TrajectoryPredictor predict_fire(
+			const SpeedVector& speed,
+			const Math::Vector2& projectile_hitbox,
+			const float charged,
+			const float wind) const;
 		virtual Network::eCharacterType get_type() const = 0;
+		// creates the projectiles of a turn ahead, so that the fire reuses them.
+		void prewarm_projectiles();
 	private:
 		Network::PlayerID m_player_id;
 		bool m_bGrounded;
@@ -82,6 +100,12 @@ namespace Fortress::ObjectBase
 		                             const GroundPointer& ground_ptr) const;
 
 		ProjectilePointer initialize_projectile(const unsigned id, const UnitVector& angle, const float charged);
+		// pooled one which is not flying, the pool grows if every one of them is flying.
+		ProjectilePointer acquire_projectile(const eProjectileType type, const unsigned id);
+		ProjectilePointer create_projectile(const eProjectileType type, const unsigned id);
+
+		// pooled projectiles per type, owned by the object manager and detached from the scene between the turns.
+		std::array<std::vector<ProjectilePointer>, 3> m_projectile_pool;
 
 		std::weak_ptr<ProjectileTimer> m_multi_projectile_timer;
 
@@ -49,6 +49,29 @@ namespace Fortress::ObjectBase
 						m_velocity = candidate;
 					}
 
+					// near the surface the distance field gives both the push out and the slope without probing.
+					if (candidate != Math::vector_inf && ground->is_distance_field_enabled())
+					{
+						const float distance = ground->safe_surface_distance_local(bottom_local_position);
+
+						// surface pixel of a grounded character reads -1, only the deeper bottom is pushed up to it.
+						if (distance < -1.0f)
+						{
+							m_position -= ground->safe_surface_normal_local(bottom_local_position) * (distance + 1.0f);
+						}
+
+						// check ground stiffness, same limit as check_angle.
+						const bool uphill = candidate.get_y() < 0.0f;
+						const bool too_stiff = -candidate.get_y() > std::fabs(candidate.get_x()) * std::tanf(Math::to_radian(80.0f));
+
+						if (uphill && too_stiff && is_moving_toward(*ground))
+						{
+							m_velocity = {};
+						}
+
+						return;
+					}
+
 					if (candidate != Math::vector_inf && bottom_check == Object::GroundState::NotDestroyed)
 					{
 						if (ground->safe_is_object_stuck_global(get_bottom()))
@@ -103,6 +126,18 @@ namespace Fortress::ObjectBase
 	{
 		if(const auto ground = ptr_ground.lock())
 		{
+			if(ground->is_distance_field_enabled())
+			{
+				const auto normal = ground->safe_surface_normal_global(get_bottom());
+
+				// slope of the tangent is -nx / ny. walls and ceilings are left to the probing.
+				if(normal.get_y() < -Math::epsilon)
+				{
+					set_movement_pitch_radian(std::atanf(-normal.get_x() / normal.get_y()));
+					return;
+				}
+			}
+
 			const bool uphilling = ground->safe_is_object_stuck_global(get_offset_bottom_forward_position());
 			Math::Vector2 delta{};
 
@@ -207,6 +242,32 @@ namespace Fortress::ObjectBase
 
 		if (const auto ground = ground_ptr.lock())
 		{
+			if (ground->is_distance_field_enabled())
+			{
+				const auto normal = ground->safe_surface_normal_local(local_position_bottom);
+
+				// far from the surface.
+				if (normal == Math::zero)
+				{
+					return Math::vector_inf;
+				}
+
+				Math::Vector2 tangent = {-normal.get_y(), normal.get_x()};
+
+				// wall, same as the probing which found nothing to climb.
+				if (std::fabs(tangent.get_x()) < Math::epsilon)
+				{
+					return Math::zero;
+				}
+
+				if ((get_offset() == Math::left) != (tangent.get_x() < 0.0f))
+				{
+					tangent = -tangent;
+				}
+
+				return tangent;
+			}
+
 			// check up-hilling condition
 			for(int x = 1; x < 100; x++)
 			{
@@ -332,10 +393,9 @@ namespace Fortress::ObjectBase
 					const auto next_velocity = get_next_velocity(bottom_local_position, ground);
 					const auto is_toward = is_moving_toward(*ground);
 
-					Debug::Log(L"Ground : " + ground->get_name());
-					Debug::Log(L"Is Toward:" + std::to_wstring(is_toward));
-					Debug::Log(L"Velocity : " + std::to_wstring(next_velocity.get_x()) + L" , " + 
-						std::to_wstring(next_velocity.get_y()));
+					Debug::Log(L"Ground : %ls", ground->get_name().c_str());
+					Debug::Log(L"Is Toward:%d", static_cast<int>(is_toward));
+					Debug::Log(L"Velocity : %f , %f", next_velocity.get_x(), next_velocity.get_y());
 					
 					// @todo : inconsistency, need to find out why this is not working
 					if(is_toward && next_velocity != Math::vector_inf)
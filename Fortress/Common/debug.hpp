@@ -1,7 +1,12 @@
 #pragma once
 #ifndef DEBUG_HPP
 #define DEBUG_HPP
+#include <cwchar>
+#include <iterator>
+#include <string_view>
+
 #include "../Common/common.h"
+#include "../Common/FrameArena.hpp"
 #include "../Common/input.hpp"
 #include "../Common/EngineHandle.h"
 
@@ -15,16 +20,46 @@ namespace Fortress
 			m_hdc = hdc;
 		}
 
-		static void Log(const std::wstring& str)
+		// the text is copied into the frame arena, and drawn before the next reset.
+		static void Log(const std::wstring_view str)
 		{
-			push([str]()
+			if(!m_bDebug)
 			{
-				TextOut(m_hdc, x, y, str.c_str(), str.length());
+				return;
+			}
+
+			wchar_t* text = FrameArena::allocate<wchar_t>(str.length());
+			std::copy(str.begin(), str.end(), text);
+			const int length = static_cast<int>(str.length());
+
+			push([text, length]()
+			{
+				TextOut(m_hdc, x, y, text, length);
 				y += y_movement;
 				y %= EngineHandle::get_handle().lock()->get_actual_max_y();
 			});
 		}
 
+		// formatted as the swprintf, without the temporary strings.
+		template <class Arg, class... Args>
+		static void Log(const wchar_t* format, Arg arg, Args... args)
+		{
+			if(!m_bDebug)
+			{
+				return;
+			}
+
+			wchar_t buffer[256];
+			const int length = std::swprintf(buffer, std::size(buffer), format, arg, args...);
+
+			if(length < 0)
+			{
+				return;
+			}
+
+			Log(std::wstring_view(buffer, length));
+		}
+
 		static void set_debug_flag();
 		static bool get_debug_flag();
 		static void push(std::function<void()> func);
@@ -43,15 +78,17 @@ namespace Fortress
 
 			if(!m_bDebug)
 			{
+				m_render_queue.clear();
 				return;
 			}
 
-			while (!m_render_queue.empty())
+			for (const auto& func : m_render_queue)
 			{
-				m_render_queue.front()();
-				m_render_queue.pop();
+				func();
 			}
 
+			m_render_queue.clear();
+
 			y = y_initial;
 		}
 
@@ -62,7 +99,8 @@ namespace Fortress
 		inline static int x = 100;
 		inline static int y = y_initial;
 		inline static HDC m_hdc;
-		inline static std::queue<std::function<void()>> m_render_queue;
+		// capacity is kept between the frames.
+		inline static std::vector<std::function<void()>> m_render_queue;
 	};
 
 	inline void Debug::set_debug_flag()
@@ -82,7 +120,7 @@ namespace Fortress
 			return;
 		}
 
-		m_render_queue.push(std::move(func));
+		m_render_queue.push_back(std::move(func));
 	}
 
 	inline void Debug::draw_line(const Math::Vector2 left, const Math::Vector2 right)
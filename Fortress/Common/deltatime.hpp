@@ -2,12 +2,18 @@
 #ifndef DELTATIME_H
 #define DELTATIME_H
 
+#include <algorithm>
+#include <cmath>
 #include <windows.h>
 #include "common.h"
 #include "../Common/EngineHandle.h"
 
 namespace Fortress
 {
+	constexpr float default_fixed_tick = 1.0f / 120.0f;
+	// frames longer than this are taken as a hitch, the simulation slows down instead of jumping.
+	constexpr int max_catch_up_steps = 8;
+
 	class DeltaTime
 	{
 	public:
@@ -23,11 +29,21 @@ namespace Fortress
 		__forceinline static void render();
 		__forceinline static float get_deltaTime();
 
+		__forceinline static bool step();
+		__forceinline static float get_alpha();
+		__forceinline static float get_frame_time();
+		__forceinline static void set_fixed_tick(float tick);
+		__forceinline static float get_fixed_tick();
+
 	private:
 		inline static LARGE_INTEGER m_cpu_frequency = {};
 		inline static LARGE_INTEGER m_prev_frequency = {};
 		inline static LARGE_INTEGER m_curr_frequency = {};
 		inline static float m_deltaTime = {};
+		inline static float m_frame_time = {};
+		inline static float m_fixed_tick = default_fixed_tick;
+		inline static float m_accumulator = {};
+		inline static int m_steps = {};
 	};
 }
 
@@ -41,15 +57,68 @@ namespace Fortress
 		QueryPerformanceCounter(&m_curr_frequency);
 
 		const float delta = static_cast<float>(m_curr_frequency.QuadPart - m_prev_frequency.QuadPart);
-		m_deltaTime = delta / static_cast<float>(m_cpu_frequency.QuadPart);
+		m_frame_time = delta / static_cast<float>(m_cpu_frequency.QuadPart);
+		m_accumulator += m_frame_time;
+		m_steps = 0;
 
 		m_prev_frequency = m_curr_frequency;
 	}
 
+	/**
+	 * \brief Consumes a fixed tick from the elapsed time, should be called until it returns false.
+	 * \return true if the simulation should be stepped once more in this cycle.
+	 */
+	__forceinline bool DeltaTime::step()
+	{
+		if (m_steps >= max_catch_up_steps)
+		{
+			// drops the time that cannot be caught up, only the fraction of a tick is left for the alpha.
+			m_accumulator = std::fmod(m_accumulator, m_fixed_tick);
+			return false;
+		}
+
+		if (m_accumulator < m_fixed_tick)
+		{
+			return false;
+		}
+
+		m_accumulator -= m_fixed_tick;
+		m_deltaTime = m_fixed_tick;
+		++m_steps;
+
+		return true;
+	}
+
+	/**
+	 * \brief Get the fraction of the tick that is not simulated yet, for the interpolation of the render.
+	 */
+	__forceinline float DeltaTime::get_alpha()
+	{
+		return (std::min)(m_accumulator / m_fixed_tick, 1.0f);
+	}
+
+	/**
+	 * \brief Get the duration of the last cycle, regardless of the tick.
+	 */
+	__forceinline float DeltaTime::get_frame_time()
+	{
+		return m_frame_time;
+	}
+
+	__forceinline void DeltaTime::set_fixed_tick(const float tick)
+	{
+		m_fixed_tick = tick;
+	}
+
+	__forceinline float DeltaTime::get_fixed_tick()
+	{
+		return m_fixed_tick;
+	}
+
 	inline void DeltaTime::render()
 	{
 		wchar_t szFloat[50]{};
-		float fps = 1.0f / m_deltaTime;
+		float fps = 1.0f / m_frame_time;
 
 		swprintf(szFloat, 50, L"DeltaTime: %5f", fps);
 		int strlen = wcsnlen_s(szFloat, 50);
@@ -59,7 +128,7 @@ namespace Fortress
 
 	/**
 	 * \brief Get DeltaTime of current system.
-	 * \return A deltaTime value, which is the duration for the one frame.
+	 * \return A deltaTime value, which is the fixed tick of the current step.
 	 */
 	__forceinline float DeltaTime::get_deltaTime()
 	{
@@ -0,0 +1,192 @@
+#pragma once
+#ifndef FIXED_HPP
+#define FIXED_HPP
+
+#include <cmath>
+#include <cstdint>
+
+#include "vector2.hpp"
+
+namespace Fortress::Math
+{
+	/**
+	 * \brief Q16.16 fixed-point number, the result of the arithmetic does not depend on the floating point
+	 * environment of the machine.
+	 */
+	class Fixed
+	{
+	public:
+		static constexpr int fraction_bits = 16;
+		static constexpr int64_t one = int64_t{1} << fraction_bits;
+
+		constexpr Fixed() : m_raw(0)
+		{
+		}
+
+		static constexpr Fixed from_raw(const int32_t raw)
+		{
+			Fixed value;
+			value.m_raw = raw;
+			return value;
+		}
+
+		// scaling by the power of two is exact, only the rounding makes the difference.
+		static Fixed from_float(const float value)
+		{
+			const long long raw = std::llround(static_cast<double>(value) * one);
+			return from_raw(saturate(raw));
+		}
+
+		float to_float() const
+		{
+			return static_cast<float>(static_cast<double>(m_raw) / one);
+		}
+
+		int32_t raw() const
+		{
+			return m_raw;
+		}
+
+		Fixed operator+(const Fixed& other) const
+		{
+			return from_raw(saturate(static_cast<int64_t>(m_raw) + other.m_raw));
+		}
+
+		Fixed operator-(const Fixed& other) const
+		{
+			return from_raw(saturate(static_cast<int64_t>(m_raw) - other.m_raw));
+		}
+
+		Fixed operator-() const
+		{
+			return from_raw(saturate(-static_cast<int64_t>(m_raw)));
+		}
+
+		Fixed operator*(const Fixed& other) const
+		{
+			const int64_t product = static_cast<int64_t>(m_raw) * other.m_raw;
+			return from_raw(saturate((product + (one >> 1)) >> fraction_bits));
+		}
+
+		Fixed operator/(const Fixed& other) const
+		{
+			if(other.m_raw == 0)
+			{
+				return from_raw(m_raw < 0 ? INT32_MIN : INT32_MAX);
+			}
+
+			return from_raw(saturate((static_cast<int64_t>(m_raw) << fraction_bits) / other.m_raw));
+		}
+
+		Fixed& operator+=(const Fixed& other)
+		{
+			return *this = *this + other;
+		}
+
+		Fixed& operator-=(const Fixed& other)
+		{
+			return *this = *this - other;
+		}
+
+		Fixed abs() const
+		{
+			return m_raw < 0 ? -*this : *this;
+		}
+
+		bool operator==(const Fixed& other) const
+		{
+			return m_raw == other.m_raw;
+		}
+
+		bool operator!=(const Fixed& other) const
+		{
+			return m_raw != other.m_raw;
+		}
+
+		bool operator<(const Fixed& other) const
+		{
+			return m_raw < other.m_raw;
+		}
+
+		bool operator<=(const Fixed& other) const
+		{
+			return m_raw <= other.m_raw;
+		}
+
+		bool operator>(const Fixed& other) const
+		{
+			return m_raw > other.m_raw;
+		}
+
+		bool operator>=(const Fixed& other) const
+		{
+			return m_raw >= other.m_raw;
+		}
+
+	private:
+		static int32_t saturate(const int64_t value)
+		{
+			if(value > INT32_MAX)
+			{
+				return INT32_MAX;
+			}
+
+			if(value < INT32_MIN)
+			{
+				return INT32_MIN;
+			}
+
+			return static_cast<int32_t>(value);
+		}
+
+		int32_t m_raw;
+	};
+
+	struct FixedVector2
+	{
+		Fixed x;
+		Fixed y;
+
+		static FixedVector2 from_vector2(const Vector2& vector)
+		{
+			return {Fixed::from_float(vector.get_x()), Fixed::from_float(vector.get_y())};
+		}
+
+		Vector2 to_vector2() const
+		{
+			return {x.to_float(), y.to_float()};
+		}
+
+		FixedVector2 operator+(const FixedVector2& other) const
+		{
+			return {x + other.x, y + other.y};
+		}
+
+		FixedVector2 operator-(const FixedVector2& other) const
+		{
+			return {x - other.x, y - other.y};
+		}
+
+		FixedVector2 operator*(const FixedVector2& other) const
+		{
+			return {x * other.x, y * other.y};
+		}
+
+		FixedVector2 operator*(const Fixed& scalar) const
+		{
+			return {x * scalar, y * scalar};
+		}
+
+		bool operator==(const FixedVector2& other) const
+		{
+			return x == other.x && y == other.y;
+		}
+
+		bool operator!=(const FixedVector2& other) const
+		{
+			return !(*this == other);
+		}
+	};
+}
+
+#endif // FIXED_HPP
@@ -7,6 +7,10 @@
 #include <vector>
 
 #include "EngineHandle.h"
+#include "GroundDistanceField.hpp"
+#include "GroundGrid.hpp"
+#include "GroundReplication.hpp"
+#include "GroundSurfaceIndex.hpp"
 #include "math.h"
 #include "rigidBody.hpp"
 #include "projectile.hpp"
@@ -20,19 +24,18 @@ namespace Fortress
 
 namespace Fortress::Object
 {
-	enum class GroundState
+	// an explosion to carve into the ground.
+	struct Crater
 	{
-		NotDestroyed = static_cast<uint8_t>(0),
-		Outline,
-		Destroyed,
-		OutOfBound,
+		Math::Vector2 center;
+		float radius;
 	};
 
-	using GroundMapKey = std::pair<int, int>;
-
 	class Ground : public Abstract::rigidBody
 	{
 	public:
+		static constexpr Abstract::eObjectTag object_tag = Abstract::eObjectTag::Ground;
+
 		Ground(
 			const std::wstring& name, 
 			const Math::Vector2& position, 
@@ -49,7 +52,8 @@ namespace Fortress::Object
 				false),
 			m_ground_hdc(nullptr),
 			m_ground_bitmap(nullptr),
-			m_tile_image(tile_image)
+			m_tile_image(tile_image),
+			m_distance_field_enabled(false)
 		{
 			Ground::initialize();
 		}
@@ -70,11 +74,36 @@ namespace Fortress::Object
 		void initialize() override;
 		void render() override;
 		void prerender() override;
+		Abstract::eObjectTag get_object_tag() const override;
 
 		void set_hitbox(const Math::Vector2& hitbox) override;
 
 		GroundState safe_is_destroyed(const Math::Vector2& local_position) const;
 		void safe_set_destroyed_global(const Math::Vector2& hit_position, const float radius);
+		// carves the craters at once, rows are written in parallel.
+		void safe_set_destroyed_global(const std::vector<Crater>& craters);
+		// defers the crater to the next safe_apply_craters, for the explosions of the same frame.
+		void queue_crater_global(const Math::Vector2& hit_position, const float radius);
+		void safe_apply_craters();
+
+		// captures the table without copying the pixels, the chunks are copied on the next write.
+		GroundSnapshot safe_take_snapshot();
+		// puts the table back to the snapshot, only the chunks changed since then are rebuilt and uploaded.
+		bool safe_restore_snapshot(const GroundSnapshot& snapshot);
+
+		// chunks are numbered in row-major order for the replication.
+		int get_chunk_count() const;
+		uint64_t safe_get_version();
+		uint32_t safe_get_chunk_checksum(const int index);
+		// out should hold ground_chunk_encoded_max bytes, returns the written size.
+		size_t safe_encode_chunk(const int index, GroundChunkEncoding& encoding, uint8_t* out);
+		// overwrites the chunk only if the decoded chunk has the given checksum.
+		bool safe_apply_chunk(
+			const int index,
+			const GroundChunkEncoding encoding,
+			const uint8_t* data,
+			const size_t size,
+			const uint32_t checksum);
 		bool safe_is_object_stuck_global(const Math::Vector2& position) const;
 		bool safe_is_object_stuck_local(const Math::Vector2& position) const;
 		Math::Vector2 safe_nearest_surface(const Math::Vector2& global_position) const;
@@ -88,6 +117,19 @@ namespace Fortress::Object
 			const Math::Vector2& global_position, const Math::Vector2& offset) const;
 
 		bool safe_is_projectile_hit(const Math::Vector2& hit_position, const std::weak_ptr<ObjectBase::projectile>& projectile_ptr) const;
+		// first solid point on the segment, vector_inf if the segment does not hit the ground.
+		Math::Vector2 safe_ray_cast_global(const Math::Vector2& from, const Math::Vector2& to) const;
+		bool safe_has_solid_in_radius_global(const Math::Vector2& position, const float radius) const;
+
+		// distance field is off by default, the surface queries fall back to probing the table when it is off.
+		void set_distance_field_enabled(const bool enabled);
+		bool is_distance_field_enabled() const;
+		// signed distance to the surface in pixel, positive in the empty space and clamped to the band.
+		float safe_surface_distance_global(const Math::Vector2& position) const;
+		// unit vector toward the empty space, zero if the position is far from the surface.
+		Math::Vector2 safe_surface_normal_global(const Math::Vector2& position) const;
+		float safe_surface_distance_local(const Math::Vector2& local_position) const;
+		Math::Vector2 safe_surface_normal_local(const Math::Vector2& local_position) const;
 	protected:
 		HDC get_ground_hdc() const;
 		HDC get_ground_mask_hdc() const;
@@ -98,10 +140,27 @@ namespace Fortress::Object
 
 		void unsafe_set_destroyed(const int x, const int y);
 		void unsafe_set_destroyed_visual(const int x, const int y);
+		// uploads the region of the table to the mask chunk by chunk. caller should hold mask_write_lock.
+		void update_mask_region(const RECT& region);
+		void mark_mask_dirty(const RECT& region);
+		void flush_mask();
+		// regions written since the last call, for the radar.
+		void take_radar_dirty_regions(std::vector<RECT>& out);
+		// composes and draws the horizontal run of chunks [chunk_begin, chunk_end) clipped by the visible area.
+		void render_chunk_run(
+			const Math::Vector2& screen_position,
+			const RECT& visible,
+			const int chunk_y,
+			const int chunk_begin,
+			const int chunk_end,
+			const bool has_hole);
 		void safe_set_circle_destroyed(const Math::Vector2& center_position, const int radius);
+		void safe_set_circles_destroyed(const std::vector<Crater>& local_craters);
 		Math::Vector2 safe_orthogonal_surface_local(
 			const Math::Vector2& local_position,
 			const int depth) const;
+		Math::Vector2 safe_ray_cast_local(const Math::Vector2& from, const Math::Vector2& to) const;
+		bool safe_has_solid_in_radius_local(const Math::Vector2& center_position, const int radius) const;
 		void unsafe_set_line_destroyed(const Math::Vector2& line, const int n);
 		void unsafe_set_line_destroyed_reverse(const Math::Vector2& line, int n);
 
@@ -110,7 +169,9 @@ namespace Fortress::Object
 		void reset_hdc();
 
 		friend Radar;
-		std::map<GroundMapKey, GroundState> m_destroyed_table;
+		GroundGrid m_destroyed_table;
+		GroundSurfaceIndex m_surface_index;
+		GroundDistanceField m_distance_field;
 		HDC m_ground_hdc;
 		HDC m_mask_hdc;
 		HDC m_buffer_hdc;
@@ -122,11 +183,24 @@ namespace Fortress::Object
 		std::unique_ptr<Graphics> m_gdi_mask_handle;
 	private:
 		void set_tile(const std::weak_ptr<ImageWrapper>& tile_image) const;
+		void reset_table(const Math::Vector2& size);
+		// caller should hold map_write_lock.
+		void update_distance_field(const RECT& region);
 
 		ImagePointer m_tile_image;
-		std::mutex map_write_lock;
+		std::vector<unsigned int> m_mask_upload_buffer;
+		// chunks changed since the last upload.
+		std::vector<bool> m_mask_dirty_flags;
+		std::vector<int> m_mask_dirty_chunks;
+		std::vector<RECT> m_radar_dirty_regions;
+		// the surface queries are const but read the index that the craters rebuild.
+		mutable std::mutex map_write_lock;
 		std::mutex mask_write_lock;
 		std::mutex mask_read_lock;
+		bool m_distance_field_enabled;
+
+		std::vector<Crater> m_crater_queue;
+		std::mutex crater_queue_lock;
 	};
 
 	inline void Ground::initialize()
@@ -158,19 +232,55 @@ namespace Fortress::Object
 
 				prerender();
 
-				// Move ground buffer to render buffer.
-				GdiTransparentBlt(
-					EngineHandle::get_handle().lock()->get_buffer_dc(),
-					pos.get_x(),
-					pos.get_y(),
-					m_hitbox.get_x(),
-					m_hitbox.get_y(),
-					m_buffer_hdc,
-					0,
-					0,
-					m_hitbox.get_x(),
-					m_hitbox.get_y(),
-					RGB(0,0,0));
+				const auto handle = EngineHandle::get_handle().lock();
+
+				// visible area in local position.
+				const RECT visible
+				{
+					(std::max)(static_cast<int>(-pos.get_x()), 0),
+					(std::max)(static_cast<int>(-pos.get_y()), 0),
+					(std::min)(static_cast<int>(-pos.get_x()) + handle->get_window_width(), m_destroyed_table.get_width()),
+					(std::min)(static_cast<int>(-pos.get_y()) + handle->get_actual_max_y(), m_destroyed_table.get_height())
+				};
+
+				if(visible.left >= visible.right || visible.top >= visible.bottom)
+				{
+					return;
+				}
+
+				const int first_x = visible.left / ground_chunk_size;
+				const int last_x = (visible.right - 1) / ground_chunk_size;
+				const int first_y = visible.top / ground_chunk_size;
+				const int last_y = (visible.bottom - 1) / ground_chunk_size;
+
+				for(int cy = first_y; cy <= last_y; ++cy)
+				{
+					int run_begin = -1;
+					bool has_hole = false;
+
+					// merges the adjacent chunks that are not fully destroyed.
+					for(int cx = first_x; cx <= last_x + 1; ++cx)
+					{
+						const bool empty = cx > last_x || 
+							m_destroyed_table.get_chunk(cx, cy).is_uniform(GroundState::Destroyed);
+
+						if(!empty)
+						{
+							if(run_begin == -1)
+							{
+								run_begin = cx;
+								has_hole = false;
+							}
+
+							has_hole |= !m_destroyed_table.get_chunk(cx, cy).is_uniform(GroundState::NotDestroyed);
+						}
+						else if(run_begin != -1)
+						{
+							render_chunk_run(pos, visible, cy, run_begin, cx, has_hole);
+							run_begin = -1;
+						}
+					}
+				}
 			}
 		}
 	}
@@ -179,45 +289,109 @@ namespace Fortress::Object
 	{
 		rigidBody::prerender();
 
+		flush_mask();
+	}
+
+	inline Abstract::eObjectTag Ground::get_object_tag() const
+	{
+		return object_tag;
+	}
+
+	inline void Ground::render_chunk_run(
+		const Math::Vector2& screen_position,
+		const RECT& visible,
+		const int chunk_y,
+		const int chunk_begin,
+		const int chunk_end,
+		const bool has_hole)
+	{
+		const RECT first = m_destroyed_table.get_chunk_rect(chunk_begin, chunk_y);
+		const RECT last = m_destroyed_table.get_chunk_rect(chunk_end - 1, chunk_y);
+
+		const int left = (std::max)(first.left, visible.left);
+		const int top = (std::max)(first.top, visible.top);
+		const int right = (std::min)(last.right, visible.right);
+		const int bottom = (std::min)(last.bottom, visible.bottom);
+		const int width = right - left;
+		const int height = bottom - top;
+
 		// Copy ground sprite to buffer.
 		BitBlt(
 			m_buffer_hdc,
-			0,
-			0,
-			m_hitbox.get_x(),
-			m_hitbox.get_y(),
+			left,
+			top,
+			width,
+			height,
 			m_ground_hdc,
-			0,
-			0,
+			left,
+			top,
 			SRCCOPY);
 
-		// AND operation with mask.
-		BitBlt(
-			m_buffer_hdc,
-			0,
-			0,
-			m_hitbox.get_x(),
-			m_hitbox.get_y(),
-			m_mask_hdc,
-			0,
-			0,
-			SRCAND);
+		// AND operation with mask, fully solid chunks are white in the mask.
+		if(has_hole)
+		{
+			BitBlt(
+				m_buffer_hdc,
+				left,
+				top,
+				width,
+				height,
+				m_mask_hdc,
+				left,
+				top,
+				SRCAND);
+		}
 
+		// Move ground buffer to render buffer.
+		GdiTransparentBlt(
+			EngineHandle::get_handle().lock()->get_buffer_dc(),
+			static_cast<int>(screen_position.get_x()) + left,
+			static_cast<int>(screen_position.get_y()) + top,
+			width,
+			height,
+			m_buffer_hdc,
+			left,
+			top,
+			width,
+			height,
+			RGB(0,0,0));
 	}
 
 	inline void Ground::set_hitbox(const Math::Vector2& hitbox)
 	{
-		m_destroyed_table.clear();
-		for(int i = 0; i < static_cast<int>(m_hitbox.get_y()); ++i)
+		reset_table(hitbox);
+		rigidBody::set_hitbox(hitbox);
+	}
+
+	inline void Ground::reset_table(const Math::Vector2& size)
+	{
 		{
-			for(int j = 0; j < static_cast<int>(m_hitbox.get_x()); ++j)
+			std::lock_guard _(map_write_lock);
+			m_destroyed_table.reset(
+				static_cast<int>(size.get_x()),
+				static_cast<int>(size.get_y()),
+				GroundState::NotDestroyed);
+			m_surface_index.rebuild(m_destroyed_table);
+
+			if(m_distance_field_enabled)
 			{
-				std::lock_guard _(map_write_lock);
-				m_destroyed_table[{i, j}] = GroundState::NotDestroyed;
+				m_distance_field.reset(m_destroyed_table);
 			}
 		}
 
-		rigidBody::set_hitbox(hitbox);
+		std::lock_guard _(mask_write_lock);
+		m_mask_dirty_flags.assign(
+			static_cast<size_t>(m_destroyed_table.get_chunk_columns()) * m_destroyed_table.get_chunk_rows(), false);
+		m_mask_dirty_chunks.clear();
+		m_radar_dirty_regions.assign(1, {0, 0, m_destroyed_table.get_width(), m_destroyed_table.get_height()});
+	}
+
+	inline void Ground::update_distance_field(const RECT& region)
+	{
+		if(m_distance_field_enabled)
+		{
+			m_distance_field.update(m_destroyed_table, region);
+		}
 	}
 
 	inline void Ground::set_tile(const std::weak_ptr<ImageWrapper>& tile_image) const
@@ -235,9 +409,9 @@ namespace Fortress::Object
 			static_cast<int>(local_position.get_y()) >= 0 && 
 			static_cast<int>(local_position.get_y()) < m_hitbox.get_y())
 		{
-			int i = static_cast<int>(local_position.get_y());
-			int j = static_cast<int>(local_position.get_x());
-			return m_destroyed_table.at({i ,j});
+			const int i = static_cast<int>(local_position.get_y());
+			const int j = static_cast<int>(local_position.get_x());
+			return m_destroyed_table.get(j, i);
 		}
 
 		return GroundState::OutOfBound;
@@ -246,7 +420,7 @@ namespace Fortress::Object
 	inline void Ground::unsafe_set_destroyed(const int x, const int y)
 	{
 		std::lock_guard _(map_write_lock);
-		m_destroyed_table[{y, x}] = GroundState::Destroyed;
+		m_destroyed_table.set(x, y, GroundState::Destroyed);
 	}
 
 	inline void Ground::unsafe_set_destroyed_visual(const int x, const int y)
@@ -255,68 +429,491 @@ namespace Fortress::Object
 		SetPixel(m_mask_hdc, x, y, RGB(0, 0, 0));
 	}
 
-	inline void Ground::safe_set_circle_destroyed(const Math::Vector2& center_position, const int radius)
+	inline void Ground::update_mask_region(const RECT& region)
 	{
-		const Math::Vector2 start_pos = {center_position.get_x() - radius, center_position.get_y()};
-		Math::Vector2 curr_pos = start_pos;
-		const Math::Vector2 end_pos = {center_position.get_x() + radius, center_position.get_y()};
+		const int left = (std::max)(static_cast<int>(region.left), 0);
+		const int top = (std::max)(static_cast<int>(region.top), 0);
+		const int right = (std::min)(static_cast<int>(region.right), m_destroyed_table.get_width());
+		const int bottom = (std::min)(static_cast<int>(region.bottom), m_destroyed_table.get_height());
 
-		float radian = 0.0f;
-		const float sin_max = Math::to_radian(180.0f);
-		const float sin_iter = sin_max / (radius * 2.0f);
+		if(left >= right || top >= bottom)
+		{
+			return;
+		}
 
-		while(curr_pos != end_pos)
+		// 0x00RRGGBB, white keeps the ground and black cuts out the ground.
+		constexpr unsigned int mask_black = 0x00000000;
+		constexpr unsigned int mask_white = 0x00ffffff;
+
+		for(int cy = top / ground_chunk_size; cy <= (bottom - 1) / ground_chunk_size; ++cy)
 		{
-			const int column_n = static_cast<int>(std::sin(radian) * static_cast<float>(radius * 2));
+			for(int cx = left / ground_chunk_size; cx <= (right - 1) / ground_chunk_size; ++cx)
+			{
+				const RECT chunk_rect = m_destroyed_table.get_chunk_rect(cx, cy);
+				const int chunk_left = (std::max)(static_cast<int>(chunk_rect.left), left);
+				const int chunk_top = (std::max)(static_cast<int>(chunk_rect.top), top);
+				const int width = (std::min)(static_cast<int>(chunk_rect.right), right) - chunk_left;
+				const int height = (std::min)(static_cast<int>(chunk_rect.bottom), bottom) - chunk_top;
+				const GroundChunk& chunk = m_destroyed_table.get_chunk(cx, cy);
+
+				if(chunk.is_uniform())
+				{
+					PatBlt(
+						m_mask_hdc,
+						chunk_left,
+						chunk_top,
+						width,
+						height,
+						chunk.uniform_state == GroundState::Destroyed ? BLACKNESS : WHITENESS);
+					continue;
+				}
 
-			const int upper_size = column_n / 2 - 1;
-			const int lower_size = column_n / 2;
+				m_mask_upload_buffer.resize(static_cast<size_t>(width) * height);
 
-			for(int i = 0; i < upper_size; ++i)
+				for(int y = 0; y < height; ++y)
+				{
+					unsigned int* row = m_mask_upload_buffer.data() + static_cast<size_t>(y) * width;
+
+					for(int x = 0; x < width; ++x)
+					{
+						row[x] = m_destroyed_table.get(chunk_left + x, chunk_top + y) == GroundState::Destroyed ? 
+							mask_black : mask_white;
+					}
+				}
+
+				BITMAPINFO info{};
+				info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+				info.bmiHeader.biWidth = width;
+				// top-down
+				info.bmiHeader.biHeight = -height;
+				info.bmiHeader.biPlanes = 1;
+				info.bmiHeader.biBitCount = 32;
+				info.bmiHeader.biCompression = BI_RGB;
+
+				SetDIBitsToDevice(
+					m_mask_hdc,
+					chunk_left,
+					chunk_top,
+					width,
+					height,
+					0,
+					0,
+					0,
+					height,
+					m_mask_upload_buffer.data(),
+					&info,
+					DIB_RGB_COLORS);
+			}
+		}
+	}
+
+	inline void Ground::mark_mask_dirty(const RECT& region)
+	{
+		const int left = (std::max)(static_cast<int>(region.left), 0);
+		const int top = (std::max)(static_cast<int>(region.top), 0);
+		const int right = (std::min)(static_cast<int>(region.right), m_destroyed_table.get_width());
+		const int bottom = (std::min)(static_cast<int>(region.bottom), m_destroyed_table.get_height());
+
+		if(left >= right || top >= bottom)
+		{
+			return;
+		}
+
+		std::lock_guard _(mask_write_lock);
+
+		for(int cy = top / ground_chunk_size; cy <= (bottom - 1) / ground_chunk_size; ++cy)
+		{
+			for(int cx = left / ground_chunk_size; cx <= (right - 1) / ground_chunk_size; ++cx)
 			{
-				if(static_cast<int>(curr_pos.get_x()) >= 0 && 
-					static_cast<int>(curr_pos.get_x()) < m_hitbox.get_x() && 
-					static_cast<int>(curr_pos.get_y() + i) >= 0 && 
-					static_cast<int>(curr_pos.get_y() + i) < m_hitbox.get_y())
+				const int index = cy * m_destroyed_table.get_chunk_columns() + cx;
+
+				if(!m_mask_dirty_flags[index])
 				{
-					unsafe_set_destroyed(curr_pos.get_x(), curr_pos.get_y() + i);
-					unsafe_set_destroyed_visual(curr_pos.get_x(), curr_pos.get_y() + i);
+					m_mask_dirty_flags[index] = true;
+					m_mask_dirty_chunks.push_back(index);
 				}
 			}
+		}
+
+		// nobody is taking the regions, falls back to the whole table.
+		if(m_radar_dirty_regions.size() >= 64)
+		{
+			m_radar_dirty_regions.assign(1, {0, 0, m_destroyed_table.get_width(), m_destroyed_table.get_height()});
+			return;
+		}
 
-			for(int i = 0; i < lower_size; ++i)
+		m_radar_dirty_regions.push_back({left, top, right, bottom});
+	}
+
+	inline void Ground::take_radar_dirty_regions(std::vector<RECT>& out)
+	{
+		std::lock_guard _(mask_write_lock);
+		out.clear();
+		out.swap(m_radar_dirty_regions);
+	}
+
+	inline void Ground::flush_mask()
+	{
+		std::lock_guard _(mask_write_lock);
+
+		for(const int index : m_mask_dirty_chunks)
+		{
+			const int columns = m_destroyed_table.get_chunk_columns();
+			update_mask_region(m_destroyed_table.get_chunk_rect(index % columns, index / columns));
+			m_mask_dirty_flags[index] = false;
+		}
+
+		m_mask_dirty_chunks.clear();
+	}
+
+	inline bool Ground::safe_has_solid_in_radius_global(const Math::Vector2& position, const float radius) const
+	{
+		return safe_has_solid_in_radius_local(to_top_left_local_position(position), static_cast<int>(radius));
+	}
+
+	inline void Ground::set_distance_field_enabled(const bool enabled)
+	{
+		std::lock_guard _(map_write_lock);
+
+		if(enabled && !m_distance_field_enabled)
+		{
+			m_distance_field.reset(m_destroyed_table);
+		}
+
+		m_distance_field_enabled = enabled;
+	}
+
+	inline bool Ground::is_distance_field_enabled() const
+	{
+		return m_distance_field_enabled;
+	}
+
+	inline float Ground::safe_surface_distance_global(const Math::Vector2& position) const
+	{
+		return safe_surface_distance_local(to_top_left_local_position(position));
+	}
+
+	inline Math::Vector2 Ground::safe_surface_normal_global(const Math::Vector2& position) const
+	{
+		return safe_surface_normal_local(to_top_left_local_position(position));
+	}
+
+	inline float Ground::safe_surface_distance_local(const Math::Vector2& local_position) const
+	{
+		return m_distance_field.get_distance(
+			static_cast<int>(local_position.get_x()), 
+			static_cast<int>(local_position.get_y()));
+	}
+
+	inline Math::Vector2 Ground::safe_surface_normal_local(const Math::Vector2& local_position) const
+	{
+		return m_distance_field.get_normal(
+			static_cast<int>(local_position.get_x()), 
+			static_cast<int>(local_position.get_y()));
+	}
+
+	inline bool Ground::safe_has_solid_in_radius_local(const Math::Vector2& center_position, const int radius) const
+	{
+		const int center_x = static_cast<int>(center_position.get_x());
+		const int center_y = static_cast<int>(center_position.get_y());
+		const RECT bound
+		{
+			center_x - radius,
+			center_y - radius,
+			center_x + radius + 1,
+			center_y + radius + 1
+		};
+
+		// decides by the occupancy summaries first.
+		if(m_destroyed_table.is_region_empty(bound))
+		{
+			return false;
+		}
+
+		const int radius_sq = radius * radius;
+
+		for(int dy = -radius; dy <= radius; ++dy)
+		{
+			const int half = static_cast<int>(std::sqrt(static_cast<float>(radius_sq - dy * dy)));
+
+			if(m_destroyed_table.find_in_row(
+				center_y + dy, center_x - half, center_x + half, GroundState::NotDestroyed) != -1)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	inline void Ground::safe_set_circle_destroyed(const Math::Vector2& center_position, const int radius)
+	{
+		if(radius <= 0)
+		{
+			return;
+		}
+
+		const int center_x = static_cast<int>(center_position.get_x());
+		const int center_y = static_cast<int>(center_position.get_y());
+		const int radius_sq = radius * radius;
+		const RECT bound
+		{
+			center_x - radius,
+			center_y - radius,
+			center_x + radius + 1,
+			center_y + radius + 1
+		};
+
+		{
+			std::lock_guard _(map_write_lock);
+
+			// nothing to carve in the open sky.
+			if(m_destroyed_table.is_region_empty(bound))
+			{
+				return;
+			}
+
+			for(int dy = -radius; dy <= radius; ++dy)
 			{
-				if(static_cast<int>(curr_pos.get_x()) >= 0 && 
-					static_cast<int>(curr_pos.get_x()) < m_hitbox.get_x() && 
-					static_cast<int>(curr_pos.get_y() - i) >= 0 && 
-					static_cast<int>(curr_pos.get_y() - i) < m_hitbox.get_y())
+				// exact half width of the row, x^2 + y^2 <= r^2
+				const int half = static_cast<int>(std::sqrt(static_cast<float>(radius_sq - dy * dy)));
+
+				m_destroyed_table.fill_span(
+					center_y + dy,
+					center_x - half,
+					center_x + half + 1,
+					GroundState::Destroyed);
+			}
+
+			m_destroyed_table.refresh(bound);
+			m_surface_index.rebuild_columns(m_destroyed_table, bound.left, bound.right);
+			update_distance_field(bound);
+		}
+
+		mark_mask_dirty(bound);
+	}
+
+	inline void Ground::safe_set_circles_destroyed(const std::vector<Crater>& local_craters)
+	{
+		struct CraterRow
+		{
+			int y;
+			int x_begin;
+			int x_end;
+		};
+
+		std::vector<RECT> bounds;
+		std::vector<CraterRow> rows;
+
+		{
+			std::lock_guard _(map_write_lock);
+
+			for(const auto& [center, radius_float] : local_craters)
+			{
+				const int radius = static_cast<int>(radius_float);
+
+				if(radius <= 0)
 				{
-					unsafe_set_destroyed(curr_pos.get_x(), curr_pos.get_y() - i);
-					unsafe_set_destroyed_visual(curr_pos.get_x(), curr_pos.get_y() - i);
+					continue;
 				}
+
+				const int center_x = static_cast<int>(center.get_x());
+				const int center_y = static_cast<int>(center.get_y());
+				const int radius_sq = radius * radius;
+				const RECT bound
+				{
+					center_x - radius,
+					center_y - radius,
+					center_x + radius + 1,
+					center_y + radius + 1
+				};
+
+				if(m_destroyed_table.is_region_empty(bound))
+				{
+					continue;
+				}
+
+				for(int dy = -radius; dy <= radius; ++dy)
+				{
+					const int half = static_cast<int>(std::sqrt(static_cast<float>(radius_sq - dy * dy)));
+					rows.push_back({center_y + dy, center_x - half, center_x + half + 1});
+				}
+
+				bounds.push_back(bound);
+			}
+
+			if(rows.empty())
+			{
+				return;
+			}
+
+			// allocation is not thread-safe, workers only touch the words.
+			for(const auto& [y, x_begin, x_end] : rows)
+			{
+				m_destroyed_table.prepare_span(y, x_begin, x_end, GroundState::Destroyed);
 			}
 
-			radian += sin_iter;
-			curr_pos = {curr_pos.get_x() + 1, curr_pos.get_y()};
+			// overlapping craters may share the words, they are merged with the atomic AND-NOT/OR.
+			std::for_each(
+				std::execution::par,
+				rows.begin(),
+				rows.end(),
+				[this](const CraterRow& row)
+				{
+					m_destroyed_table.fill_span_atomic(row.y, row.x_begin, row.x_end, GroundState::Destroyed);
+				});
+
+			for(const auto& bound : bounds)
+			{
+				m_destroyed_table.refresh(bound);
+				m_surface_index.rebuild_columns(m_destroyed_table, bound.left, bound.right);
+				update_distance_field(bound);
+			}
 		}
+
+		// dirty chunks are merged, the mask is uploaded once on the next prerender.
+		for(const auto& bound : bounds)
+		{
+			mark_mask_dirty(bound);
+		}
+	}
+
+	inline GroundSnapshot Ground::safe_take_snapshot()
+	{
+		std::lock_guard _(map_write_lock);
+		return m_destroyed_table.snapshot();
+	}
+
+	inline bool Ground::safe_restore_snapshot(const GroundSnapshot& snapshot)
+	{
+		std::vector<RECT> changed;
+
+		{
+			std::lock_guard _(map_write_lock);
+
+			if(!m_destroyed_table.restore(snapshot, changed))
+			{
+				return false;
+			}
+
+			for(const auto& rect : changed)
+			{
+				m_surface_index.rebuild_columns(m_destroyed_table, rect.left, rect.right);
+				update_distance_field(rect);
+			}
+		}
+
+		for(const auto& rect : changed)
+		{
+			mark_mask_dirty(rect);
+		}
+
+		return true;
+	}
+
+	inline int Ground::get_chunk_count() const
+	{
+		return m_destroyed_table.get_chunk_columns() * m_destroyed_table.get_chunk_rows();
+	}
+
+	inline uint64_t Ground::safe_get_version()
+	{
+		std::lock_guard _(map_write_lock);
+		return m_destroyed_table.get_version();
+	}
+
+	inline uint32_t Ground::safe_get_chunk_checksum(const int index)
+	{
+		const int columns = m_destroyed_table.get_chunk_columns();
+
+		std::lock_guard _(map_write_lock);
+		return GroundChunkCodec::get_checksum(m_destroyed_table, index % columns, index / columns);
+	}
+
+	inline size_t Ground::safe_encode_chunk(const int index, GroundChunkEncoding& encoding, uint8_t* out)
+	{
+		const int columns = m_destroyed_table.get_chunk_columns();
+
+		std::lock_guard _(map_write_lock);
+		return GroundChunkCodec::encode(m_destroyed_table, index % columns, index / columns, encoding, out);
+	}
+
+	inline bool Ground::safe_apply_chunk(
+		const int index,
+		const GroundChunkEncoding encoding,
+		const uint8_t* data,
+		const size_t size,
+		const uint32_t checksum)
+	{
+		if(index < 0 || index >= get_chunk_count())
+		{
+			return false;
+		}
+
+		const int chunk_x = index % m_destroyed_table.get_chunk_columns();
+		const int chunk_y = index / m_destroyed_table.get_chunk_columns();
+		const RECT rect = m_destroyed_table.get_chunk_rect(chunk_x, chunk_y);
+		GroundChunkData words;
+
+		{
+			std::lock_guard _(map_write_lock);
+
+			if(!GroundChunkCodec::decode(m_destroyed_table, chunk_x, chunk_y, encoding, data, size, words) ||
+				GroundChunkCodec::get_checksum(words) != checksum)
+			{
+				return false;
+			}
+
+			m_destroyed_table.assign_chunk(chunk_x, chunk_y, words);
+			m_destroyed_table.refresh(rect);
+			m_surface_index.rebuild_columns(m_destroyed_table, rect.left, rect.right);
+			update_distance_field(rect);
+		}
+
+		mark_mask_dirty(rect);
+		return true;
 	}
 
 	inline void Ground::unsafe_set_line_destroyed(const Math::Vector2& line, const int n)
 	{
-		for(int i = 0; i < n; ++i)
+		if(n <= 0)
+		{
+			return;
+		}
+
+		const int x = static_cast<int>(line.get_x());
+		const int y = static_cast<int>(line.get_y());
+
 		{
-			unsafe_set_destroyed(line.get_x() + i, line.get_y());
-			unsafe_set_destroyed_visual(line.get_x() + i, line.get_y());
+			std::lock_guard _(map_write_lock);
+			m_destroyed_table.fill_span(y, x, x + n, GroundState::Destroyed);
+			m_destroyed_table.refresh({x, y, x + n, y + 1});
+			m_surface_index.rebuild_columns(m_destroyed_table, x, x + n);
+			update_distance_field({x, y, x + n, y + 1});
 		}
+
+		mark_mask_dirty({x, y, x + n, y + 1});
 	}
 
 	inline void Ground::unsafe_set_line_destroyed_reverse(const Math::Vector2& line, const int n)
 	{
-		for(int i = n - 1; i >= 0 ; --i)
+		if(n <= 0)
 		{
-			unsafe_set_destroyed(line.get_x() - i, line.get_y());
-			unsafe_set_destroyed_visual(line.get_x() - i, line.get_y());
+			return;
 		}
+
+		const int x = static_cast<int>(line.get_x());
+		const int y = static_cast<int>(line.get_y());
+
+		{
+			std::lock_guard _(map_write_lock);
+			m_destroyed_table.fill_span(y, x - n + 1, x + 1, GroundState::Destroyed);
+			m_destroyed_table.refresh({x - n + 1, y, x + 1, y + 1});
+			m_surface_index.rebuild_columns(m_destroyed_table, x - n + 1, x + 1);
+			update_distance_field({x - n + 1, y, x + 1, y + 1});
+		}
+
+		mark_mask_dirty({x - n + 1, y, x + 1, y + 1});
 	}
 
 	inline bool Ground::safe_is_projectile_hit(
@@ -341,6 +938,133 @@ namespace Fortress::Object
 		return false;
 	}
 
+	inline Math::Vector2 Ground::safe_ray_cast_global(const Math::Vector2& from, const Math::Vector2& to) const
+	{
+		const auto hit = safe_ray_cast_local(
+			to_top_left_local_position(from), 
+			to_top_left_local_position(to));
+
+		if(hit == Math::vector_inf)
+		{
+			return Math::vector_inf;
+		}
+
+		return hit + get_top_left();
+	}
+
+	inline Math::Vector2 Ground::safe_ray_cast_local(const Math::Vector2& from, const Math::Vector2& to) const
+	{
+		const int width = m_destroyed_table.get_width();
+		const int height = m_destroyed_table.get_height();
+
+		if(width == 0 || height == 0)
+		{
+			return Math::vector_inf;
+		}
+
+		const Math::Vector2 delta = to - from;
+		const float dx = delta.get_x();
+		const float dy = delta.get_y();
+
+		// clips the segment with the table bound, t is in [0, 1] of the segment.
+		float t_enter = 0.0f;
+		float t_exit = 1.0f;
+
+		const float p[4] = { -dx, dx, -dy, dy };
+		const float q[4] =
+		{
+			from.get_x(),
+			static_cast<float>(width) - from.get_x(),
+			from.get_y(),
+			static_cast<float>(height) - from.get_y()
+		};
+
+		for(int i = 0; i < 4; ++i)
+		{
+			if(p[i] == 0.0f)
+			{
+				if(q[i] < 0.0f)
+				{
+					return Math::vector_inf;
+				}
+
+				continue;
+			}
+
+			const float r = q[i] / p[i];
+
+			if(p[i] < 0.0f)
+			{
+				t_enter = (std::max)(t_enter, r);
+			}
+			else
+			{
+				t_exit = (std::min)(t_exit, r);
+			}
+		}
+
+		if(t_enter > t_exit)
+		{
+			return Math::vector_inf;
+		}
+
+		const auto to_cell = [](const float value, const int size)
+		{
+			return std::clamp(static_cast<int>(std::floor(value)), 0, size - 1);
+		};
+
+		const int step_x = dx > 0.0f ? 1 : dx < 0.0f ? -1 : 0;
+		const int step_y = dy > 0.0f ? 1 : dy < 0.0f ? -1 : 0;
+
+		// nudge for stepping over the cell boundary, 1/1000 pixel.
+		const float t_nudge = 0.001f / (std::max)(std::abs(dx), std::abs(dy));
+		float t = t_enter;
+
+		// marches through the largest empty cell of the pyramid (64x64 chunk, 8x8 block or pixel)
+		// containing the current point, then jumps to where the segment exits that cell.
+		while(t <= t_exit)
+		{
+			const float px = from.get_x() + dx * t;
+			const float py = from.get_y() + dy * t;
+			const int x = to_cell(px, width);
+			const int y = to_cell(py, height);
+
+			int cell_size = 1;
+
+			if(m_destroyed_table.is_chunk_empty(x, y))
+			{
+				cell_size = ground_chunk_size;
+			}
+			else if(m_destroyed_table.is_block_empty(x, y))
+			{
+				cell_size = ground_block_size;
+			}
+			else if(m_destroyed_table.get(x, y) == GroundState::NotDestroyed)
+			{
+				return {px, py};
+			}
+
+			const int cell_x = x / cell_size * cell_size;
+			const int cell_y = y / cell_size * cell_size;
+
+			const float t_next_x = step_x > 0 ? (static_cast<float>(cell_x + cell_size) - from.get_x()) / dx :
+				step_x < 0 ? (static_cast<float>(cell_x) - from.get_x()) / dx : INFINITY;
+			const float t_next_y = step_y > 0 ? (static_cast<float>(cell_y + cell_size) - from.get_y()) / dy :
+				step_y < 0 ? (static_cast<float>(cell_y) - from.get_y()) / dy : INFINITY;
+			const float t_next = (std::min)(t_next_x, t_next_y);
+
+			// zero-length segment or the last cell.
+			if(t_next == INFINITY)
+			{
+				break;
+			}
+
+			t = (std::max)(t_next, t) + t_nudge;
+		}
+
+		return Math::vector_inf;
+	}
+
 	inline bool Ground::safe_is_object_stuck_global(const Math::Vector2& global_position) const
 	{
 		const auto local_position = to_top_left_local_position(global_position);
@@ -349,6 +1073,22 @@ namespace Fortress::Object
 
 	inline bool Ground::safe_is_object_stuck_local(const Math::Vector2& local_position) const
 	{
+		const int x = static_cast<int>(local_position.get_x());
+		const int y = static_cast<int>(local_position.get_y());
+
+		// neighbours are all in a solid block, or none of them can be solid.
+		if(m_destroyed_table.is_region_solid({x - 1, y - 1, x + 2, y + 2}) && 
+			m_destroyed_table.is_in_bound(x - 1, y - 1) &&
+			m_destroyed_table.is_in_bound(x + 1, y + 1))
+		{
+			return true;
+		}
+
+		if(m_destroyed_table.is_region_empty({x - 1, y - 1, x + 2, y + 2}))
+		{
+			return false;
+		}
+
 		Math::Vector2 offsets[4] =
 		{
 			{-1.0f, 0.0f},
@@ -370,26 +1110,36 @@ namespace Fortress::Object
 
 	inline Math::Vector2 Ground::safe_nearest_surface(const Math::Vector2& global_position) const
 	{
-		const auto o_local_position = to_top_left_local_position(global_position);
-		auto local_position = to_top_left_local_position(global_position);
+		const auto local_position = to_top_left_local_position(global_position);
 
 		if(local_position.get_y() <= 0)
 		{
 			return {0, -local_position.get_y()};
 		}
 
-		while(local_position.get_y() > 0)
+		// walks up one pixel at a time while y > 0, integer y stops before the row 0.
+		const int steps = static_cast<int>(std::ceil(local_position.get_y()));
+		const int start_row = static_cast<int>(local_position.get_y());
+		const int last_row = start_row - steps + 1;
+		const int x = static_cast<int>(local_position.get_x());
+
+		int found = -1;
+
 		{
-			if(safe_is_destroyed(local_position) == GroundState::Destroyed)
+			std::lock_guard _(map_write_lock);
+
+			if(local_position.get_x() > -1.0f && m_surface_index.is_in_bound(x))
 			{
-				auto delta = o_local_position - local_position;
-				return delta;
+				found = m_surface_index.find_empty_upward(x, start_row, last_row);
 			}
+		}
 
-			local_position = {local_position.get_x(), local_position.get_y() - 1};
+		if(found != -1)
+		{
+			return {0, static_cast<float>(start_row - found)};
 		}
 
-		return {0, -local_position.get_y()};
+		return {0, -(local_position.get_y() - static_cast<float>(steps))};
 	}
 
 	inline Math::Vector2 Ground::safe_orthogonal_surface_global(const Math::Vector2& global_position, const int depth, const int start_y) const
@@ -414,20 +1164,24 @@ namespace Fortress::Object
 	{
 		const auto local_position = to_top_left_local_position(global_position);
 		const int i_offset = offset == Math::left ? -1 : 1;
+		const int width = static_cast<int>(m_hitbox.get_x());
+		const int x = static_cast<int>(local_position.get_x());
+		const int y = static_cast<int>(local_position.get_y());
 
-		for(int i = 0; 
-			i > -m_hitbox.get_x() && i < m_hitbox.get_x(); 
-			i += i_offset)
+		if(local_position.get_y() <= -1.0f)
 		{
-			const Math::Vector2 new_pos = {local_position.get_x() + i, local_position.get_y()};
+			return Math::vector_inf;
+		}
 
-			if(safe_is_destroyed(new_pos) == GroundState::NotDestroyed)
-			{
-				return new_pos - local_position;
-			}
+		const int found = m_destroyed_table.find_in_row(
+			y, x, x + i_offset * (width - 1), GroundState::NotDestroyed);
+
+		if(found == -1)
+		{
+			return Math::vector_inf;
 		}
 
-		return Math::vector_inf;
+		return {static_cast<float>(found - x), 0};
 	}
 
 	inline Math::Vector2 Ground::safe_orthogonal_surface_local(const Math::Vector2& local_position, const int depth) const
@@ -440,17 +1194,25 @@ namespace Fortress::Object
 			end_y = m_hitbox.get_y();
 		}
 
-		for(int y = start_y; y < end_y; ++y)
+		const int x = static_cast<int>(local_position.get_x());
+
+		int found = -1;
+
 		{
-			const Math::Vector2 new_pos = {local_position.get_x(), y};
+			std::lock_guard _(map_write_lock);
 
-			if(safe_is_destroyed(new_pos) == GroundState::NotDestroyed)
+			if(local_position.get_x() > -1.0f && m_surface_index.is_in_bound(x))
 			{
-				return new_pos - local_position;
+				found = m_surface_index.find_solid_downward(x, start_y, end_y);
 			}
 		}
 
-		return Math::vector_inf;
+		if(found == -1)
+		{
+			return Math::vector_inf;
+		}
+
+		return Math::Vector2{local_position.get_x(), static_cast<float>(found)} - local_position;
 	}
 
 	inline HDC Ground::get_ground_hdc() const
@@ -470,67 +1232,31 @@ namespace Fortress::Object
 
 	inline void Ground::force_update_mask()
 	{
-		const auto mask_bitmap = get_mask_bitmap_copy();
-		BitmapData bitmap_info{};
-		
-		const UINT width = mask_bitmap->GetWidth();
-		const UINT height = mask_bitmap->GetHeight();
-
-		const Rect mask_size = Rect
 		{
-			0,
-			0,
-			static_cast<int>(width),
-			static_cast<int>(height)
-		};
+			std::lock_guard _(map_write_lock);
+			// pixel-wise writes on load leave the uniform chunks allocated and the summaries stale.
+			m_destroyed_table.refresh({0, 0, m_destroyed_table.get_width(), m_destroyed_table.get_height()});
+			m_surface_index.rebuild(m_destroyed_table);
 
-		// assuming we are using hdc only.
-		mask_bitmap->LockBits(
-			&mask_size,
-			ImageLockModeWrite,
-			PixelFormat32bppARGB,
-			&bitmap_info);
-
-		// used type unsigned int (4 bytes, 1b-A 1b-R 1b-G 1b-B)
-		auto* const direct_access_ptr = static_cast<unsigned int*>(bitmap_info.Scan0);
-		const UINT stride = std::abs(bitmap_info.Stride);
-
-		// probably due to non 4-byte reads happened.
-		assert(stride / 4 == width);
-		const UINT array_size = width * height;
-		// A 1111 1111 R 0000 0000 G 0000 0000 B 0000 0000
-		constexpr unsigned int alpha_black = 0xff000000;
-
-		// A 1111 1111 R 1111 1111 G 1111 1111 B 1111 1111
-		constexpr unsigned int alpha_white = 0xffffffff;
-
-		std::for_each(
-			std::execution::par,
-			direct_access_ptr,
-			direct_access_ptr + array_size,
-			[&](unsigned int& pixel)
+			if(m_distance_field_enabled)
 			{
-				const size_t index = std::distance(direct_access_ptr, &pixel);
-				const size_t y = index / width;
-				const size_t x = index % width;
-
-				if(m_destroyed_table.at({y, x}) == GroundState::Destroyed)
-				{
-					pixel = alpha_black;
-				}
-				else
-				{
-					pixel = alpha_white;
-				}
-		});
-
-		mask_bitmap->UnlockBits(&bitmap_info);
+				m_distance_field.reset(m_destroyed_table);
+			}
+		}
 
-		HBITMAP updated;
-		mask_bitmap->GetHBITMAP(Color(255, 0, 0, 0), &updated);
+		std::lock_guard _(mask_write_lock);
 
-		m_mask_bitmap = updated;
-		DeleteObject(SelectObject(m_mask_hdc, updated));
+		update_mask_region(
+			{
+				0,
+				0,
+				m_destroyed_table.get_width(),
+				m_destroyed_table.get_height()
+			});
+
+		std::fill(m_mask_dirty_flags.begin(), m_mask_dirty_flags.end(), false);
+		m_mask_dirty_chunks.clear();
+		m_radar_dirty_regions.assign(1, {0, 0, m_destroyed_table.get_width(), m_destroyed_table.get_height()});
 	}
 
 	inline void Ground::safe_set_destroyed_global(
@@ -541,6 +1267,40 @@ namespace Fortress::Object
 		safe_set_circle_destroyed(local_position, radius);
 	}
 
+	inline void Ground::safe_set_destroyed_global(const std::vector<Crater>& craters)
+	{
+		std::vector<Crater> local_craters;
+		local_craters.reserve(craters.size());
+
+		for(const auto& [center, radius] : craters)
+		{
+			local_craters.push_back({to_top_left_local_position(center), radius});
+		}
+
+		safe_set_circles_destroyed(local_craters);
+	}
+
+	inline void Ground::queue_crater_global(const Math::Vector2& hit_position, const float radius)
+	{
+		std::lock_guard _(crater_queue_lock);
+		m_crater_queue.push_back({to_top_left_local_position(hit_position), radius});
+	}
+
+	inline void Ground::safe_apply_craters()
+	{
+		std::vector<Crater> craters;
+
+		{
+			std::lock_guard _(crater_queue_lock);
+			craters.swap(m_crater_queue);
+		}
+
+		if(!craters.empty())
+		{
+			safe_set_circles_destroyed(craters);
+		}
+	}
+
 	inline COLORREF Ground::get_pixel_threadsafe(const int x, const int y)
 	{
 		std::lock_guard _(mask_read_lock);
@@ -569,6 +1329,8 @@ namespace Fortress::Object
 			ReleaseDC(nullptr, m_mask_hdc);
 		}
 
+		// surfaces cover the whole ground unlike the chunked table, so they still grow with the area.
+		// tiling them would need the sprite images to be tiled too.
 		m_ground_hdc = CreateCompatibleDC(EngineHandle::get_handle().lock()->get_main_dc());
 		m_ground_bitmap = CreateCompatibleBitmap(
 			EngineHandle::get_handle().lock()->get_main_dc(), m_hitbox.get_x(), m_hitbox.get_y());
@@ -587,15 +1349,7 @@ namespace Fortress::Object
 
 		m_gdi_mask_handle.reset(Graphics::FromHDC(m_mask_hdc));
 
-		for(int i = 0; i < static_cast<int>(m_hitbox.get_y()); ++i)
-		{
-			for(int j = 0; j < static_cast<int>(m_hitbox.get_x()); ++j)
-			{
-				std::lock_guard _(map_write_lock);
-				m_destroyed_table[{i, j}] = GroundState::NotDestroyed;
-			}
-		}
-
+		reset_table(m_hitbox);
 		force_update_mask();
 	}
 }
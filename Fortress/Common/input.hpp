@@ -95,20 +95,30 @@ namespace Fortress
 		{
 			uint8_t m_native_code;
 			_eKeyState m_state;
+			// state seen by the simulation, the edges of the frames are latched until a tick takes them.
+			_eKeyState m_tick_state;
 			bool m_pressed;
+			bool m_pending_down;
+			bool m_pending_up;
 
 			Key()
 			{
 				m_native_code = 0;
 				m_state = _eKeyState::None;
+				m_tick_state = _eKeyState::None;
 				m_pressed = false;
+				m_pending_down = false;
+				m_pending_up = false;
 			}
 
 			explicit Key(const uint8_t native_code)
 			{
 				m_native_code = native_code;
 				m_state = _eKeyState::None;
+				m_tick_state = _eKeyState::None;
 				m_pressed = false;
+				m_pending_down = false;
+				m_pending_up = false;
 			}
 
 			Key& operator=(const Key& other) = default;
@@ -116,12 +126,16 @@ namespace Fortress
 
 		inline static void initialize();
 		inline static void update();
+		// getKey series between these see the state of the tick, each edge is seen by one tick only.
+		inline static void begin_tick();
+		inline static void end_tick();
 		__forceinline static bool getKeyDown(eKeyCode);
 		__forceinline static bool getKeyUp(eKeyCode);
 		__forceinline static bool getKey(eKeyCode);
 
 	private:
 		inline static std::vector<Key> m_keys;
+		inline static bool m_ticking = false;
 
 		inline static void checkKeyState();
 	};
@@ -159,6 +173,7 @@ namespace Fortress
 					{
 						key.m_state = _eKeyState::Down;
 						key.m_pressed = true;
+						key.m_pending_down = true;
 					}
 				}
 				else
@@ -167,6 +182,7 @@ namespace Fortress
 					{
 						key.m_state = _eKeyState::Up;
 						key.m_pressed = false;
+						key.m_pending_up = true;
 					}
 					else
 					{
@@ -187,19 +203,51 @@ namespace Fortress
 		}
 	}
 
+	void Input::begin_tick()
+	{
+		for (Key& key : m_keys)
+		{
+			// a tap in a frame is given as the down in this tick and the up in the next one.
+			if (key.m_pending_down)
+			{
+				key.m_tick_state = _eKeyState::Down;
+				key.m_pending_down = false;
+			}
+			else if (key.m_pending_up)
+			{
+				key.m_tick_state = _eKeyState::Up;
+				key.m_pending_up = false;
+			}
+			else
+			{
+				key.m_tick_state = key.m_pressed ? _eKeyState::Pressing : _eKeyState::None;
+			}
+		}
+
+		m_ticking = true;
+	}
+
+	void Input::end_tick()
+	{
+		m_ticking = false;
+	}
+
 	bool Input::getKeyDown(const eKeyCode code)
 	{
-		return m_keys[static_cast<size_t>(code)].m_state == _eKeyState::Down;
+		const Key& key = m_keys[static_cast<size_t>(code)];
+		return (m_ticking ? key.m_tick_state : key.m_state) == _eKeyState::Down;
 	}
 
 	bool Input::getKeyUp(const eKeyCode code)
 	{
-		return m_keys[static_cast<size_t>(code)].m_state == _eKeyState::Up;
+		const Key& key = m_keys[static_cast<size_t>(code)];
+		return (m_ticking ? key.m_tick_state : key.m_state) == _eKeyState::Up;
 	}
 
 	bool Input::getKey(const eKeyCode code)
 	{
-		return m_keys[static_cast<size_t>(code)].m_state == _eKeyState::Pressing;
+		const Key& key = m_keys[static_cast<size_t>(code)];
+		return (m_ticking ? key.m_tick_state : key.m_state) == _eKeyState::Pressing;
 	}
 }
 
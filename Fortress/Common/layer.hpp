@@ -1,10 +1,12 @@
 #pragma once
 #ifndef LAYER_HPP
 #define LAYER_HPP
+#include <algorithm>
 #include <vector>
 
 #include "entity.hpp"
 #include "object.hpp"
+#include "objectManager.hpp"
 
 namespace Fortress::Abstract
 {
@@ -43,7 +45,12 @@ namespace Fortress::Abstract
 		void remove_game_object(const std::weak_ptr<object>& obj);
 
 	private:
-		std::vector<std::weak_ptr<object>> m_objects;
+		template <typename Function>
+		void for_each_object(const Function& function) const;
+
+		std::vector<ObjectHandle> m_objects;
+		// objects which are not created by the object manager.
+		std::vector<std::weak_ptr<object>> m_unmanaged;
 	};
 }
 
@@ -63,66 +70,100 @@ namespace Fortress::Abstract
 	inline void Layer::initialize()
 	{
 		m_objects = {};
+		m_unmanaged = {};
 	}
 
 	inline void Layer::update() const
 	{
-		for (const auto& obj : m_objects)
+		for_each_object([](object& obj)
 		{
-			if(const auto ptr = obj.lock())
-			{
-				ptr->update();	
-			}
-		}
+			obj.update();
+		});
 	}
 
 	inline void Layer::render() const
 	{
-		for(const auto& obj : m_objects)
+		for_each_object([](object& obj)
 		{
-			if(const auto ptr = obj.lock())
-			{
-				ptr->render();	
-			}
-		}
+			obj.render();
+		});
 	}
 
 	inline void Layer::deactivate() const
 	{
-		for(const auto& obj : m_objects)
+		for_each_object([](object& obj)
 		{
-			if(const auto ptr = obj.lock())
-			{
-				ptr->set_disabled();	
-			}
-		}
+			obj.set_disabled();
+		});
 	}
 
 	inline void Layer::activate() const
 	{
-		for(const auto& obj : m_objects)
+		for_each_object([](object& obj)
 		{
-			if(const auto ptr = obj.lock())
-			{
-				ptr->set_enabled();	
-			}
-		}
+			obj.set_enabled();
+		});
 	}
 
 	inline void Layer::add_game_object(const std::weak_ptr<object>& object)
 	{
-		m_objects.push_back(object);
+		const auto ptr = object.lock();
+
+		if(!ptr)
+		{
+			return;
+		}
+
+		if(ptr->get_handle().is_valid())
+		{
+			m_objects.push_back(ptr->get_handle());
+		}
+		else
+		{
+			m_unmanaged.push_back(object);
+		}
 	}
 
 	inline void Layer::remove_game_object(const std::weak_ptr<object>& obj)
 	{
+		const auto ptr = obj.lock();
+
+		if(!ptr)
+		{
+			return;
+		}
+
 		m_objects.erase(
-			std::remove_if(m_objects.begin(), m_objects.end(),
-				[this, obj](const std::weak_ptr<object>& p)
+			std::remove(m_objects.begin(), m_objects.end(), ptr->get_handle()),
+			m_objects.end());
+		m_unmanaged.erase(
+			std::remove_if(m_unmanaged.begin(), m_unmanaged.end(),
+				[&ptr](const std::weak_ptr<object>& p)
 			{
-				return p.lock() == obj.lock();
+				return p.lock() == ptr;
 			}),
-			m_objects.end());
+			m_unmanaged.end());
+	}
+
+	template <typename Function>
+	void Layer::for_each_object(const Function& function) const
+	{
+		// objects can be added to the layer while visiting.
+		for(size_t i = 0; i < m_objects.size(); ++i)
+		{
+			if(object* ptr = ObjectBase::ObjectManager::find(m_objects[i]))
+			{
+				function(*ptr);
+			}
+		}
+
+		for(size_t i = 0; i < m_unmanaged.size(); ++i)
+		{
+			if(const auto ptr = m_unmanaged[i].lock())
+			{
+				function(*ptr);
+			}
+		}
 	}
 }
 #endif // LAYER_HPP
@@ -62,6 +62,11 @@ namespace Fortress::Network
 		ProjectileFire = 0x900,
 		ProjectileFlying = 0x901,
 		ProjectileHit = 0x902,
+
+		TerrainDigestReq = 0xA00,
+		TerrainDigest = 0xA01,
+		TerrainChunkReq = 0xA02,
+		TerrainChunk = 0xA03,
 	};
 
 	enum class eCharacterType
@@ -91,6 +96,13 @@ namespace Fortress::Network
 	using RoomID = int;
 	using CRC32 = uint32_t;
 
+	// chunk checksums per digest, also the range of the chunk request.
+	constexpr int terrain_digest_chunks = 256;
+	// fits in a single datagram with the header, a raw chunk (1024 bytes) always fits.
+	constexpr int terrain_payload_size = 1200;
+	// chunk index (2), encoding (1), size (2) in front of each encoded chunk of the payload.
+	constexpr int terrain_chunk_header_size = 5;
+
 	struct Room
 	{
 		char name[15][5];
@@ -176,6 +188,8 @@ namespace Fortress::Network
 
 	struct GameStartMsg : Message
 	{
+		// every peer integrates in the fixed-point.
+		bool fixed_point;
 	};
 
 	struct GOMsg : Message
@@ -230,6 +244,9 @@ namespace Fortress::Network
 	{
 		unsigned int prj_id;
 		eProjectileType prj_type;
+		// launch of the flight, for validating the hit.
+		Math::Vector2 velocity;
+		Math::Vector2 speed;
 	};
 
 	struct ProjectileFlyingMsg : PositionMsg
@@ -277,6 +294,41 @@ namespace Fortress::Network
 	{
 	};
 
+	struct TerrainDigestReqMsg : Message
+	{
+		PlayerID target_player_id;
+		unsigned int ground_index;
+	};
+
+	struct TerrainDigestMsg : Message
+	{
+		unsigned int ground_index;
+		uint64_t version;
+		int total_chunks;
+		int first_chunk;
+		int chunk_count;
+		CRC32 chunk_crc[terrain_digest_chunks];
+	};
+
+	struct TerrainChunkReqMsg : Message
+	{
+		PlayerID target_player_id;
+		unsigned int ground_index;
+		uint64_t version;
+		int first_chunk;
+		// bit n is set if first_chunk + n is requested.
+		uint8_t requested[terrain_digest_chunks / 8];
+	};
+
+	struct TerrainChunkMsg : Message
+	{
+		unsigned int ground_index;
+		uint64_t version;
+		uint16_t chunk_count;
+		uint16_t payload_size;
+		uint8_t payload[terrain_payload_size];
+	};
+
 	union Data final
 	{
 		PingMsg ping;
@@ -304,11 +356,18 @@ namespace Fortress::Network
 		LoadDoneMsg load_done;
 		GameStartMsg start;
 		GameInitMsg game_init;
+		TerrainDigestReqMsg terrain_digest_req;
+		TerrainDigestMsg terrain_digest;
+		TerrainChunkReqMsg terrain_chunk_req;
+		TerrainChunkMsg terrain_chunk;
 	};
 
 	// UDP Packet size limit
 	// @todo: send separately.
 	static_assert(sizeof(Data) <= 65507);
+	// terrain is sent per MTU.
+	static_assert(sizeof(TerrainDigestMsg) <= 1472);
+	static_assert(sizeof(TerrainChunkMsg) <= 1472);
 
 	template <typename T, typename... Args>
 	static T create_network_message(Args... args)
@@ -2,16 +2,73 @@
 #define OBJECT_HPP
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <memory>
 
 #include "vector2.hpp"
 #include "entity.hpp"
 
+namespace Fortress::ObjectBase
+{
+	class ObjectManager;
+}
+
 namespace Fortress::Abstract
 {
+	// typed registry of the scene which keeps the object, besides the layer.
+	enum class eObjectTag
+	{
+		None = 0,
+		Character,
+		Projectile,
+		Ground,
+		_END
+	};
+
+	/**
+	 * \brief Stable reference of the object in the object manager. index of the slot is in the lower bits and the
+	 * generation of the slot is in the upper bits, so the handle of the released object does not find the new one.
+	 * zero is never issued.
+	 */
+	struct ObjectHandle
+	{
+		static constexpr int index_bits = 20;
+		static constexpr uint32_t index_mask = (1u << index_bits) - 1;
+
+		uint32_t value = 0;
+
+		uint32_t get_index() const
+		{
+			return value & index_mask;
+		}
+
+		uint32_t get_generation() const
+		{
+			return value >> index_bits;
+		}
+
+		bool is_valid() const
+		{
+			return value != 0;
+		}
+
+		bool operator==(const ObjectHandle& other) const
+		{
+			return value == other.value;
+		}
+
+		bool operator!=(const ObjectHandle& other) const
+		{
+			return value != other.value;
+		}
+	};
+
 	class object : public entity
 	{
 	public:
+		static constexpr eObjectTag object_tag = eObjectTag::None;
+
 		Math::Vector2 m_hitbox;
 		Math::Vector2 m_position;
 
@@ -36,6 +93,10 @@ namespace Fortress::Abstract
 		__forceinline virtual object& operator+=(const Math::Vector2& vector);
 
 		bool is_active() const;
+		// tag of the most derived type, same as object_tag of it.
+		virtual eObjectTag get_object_tag() const;
+		// invalid if the object is not created by the object manager.
+		ObjectHandle get_handle() const;
 		virtual void set_disabled();
 		virtual void set_enabled();
 
@@ -48,7 +109,7 @@ namespace Fortress::Abstract
 		__forceinline Math::Vector2 get_bottom_left() const;
 		__forceinline Math::Vector2 get_bottom_right() const;
 		__forceinline Math::Vector2 get_center() const;
-		std::vector<Math::Vector2> get_all_hit_points() const;
+		std::array<Math::Vector2, 10> get_all_hit_points() const;
 		__forceinline Math::Vector2 get_dir_point(const eDirVector& e_vector) const;
 		__forceinline Math::Vector2 to_top_left_local_position(const Math::Vector2& other) const;
 		__forceinline Math::Vector2 to_top_right_local_position(const Math::Vector2& other) const;
@@ -56,6 +117,12 @@ namespace Fortress::Abstract
 		__forceinline Math::Vector2 get_nearest_point(const Math::Vector2& other) const;
 
 		__forceinline float get_mass() const;
+
+		// keeps the position before the physics step for the render.
+		__forceinline void store_previous_position();
+		__forceinline Math::Vector2 get_previous_center() const;
+		// position between the previous and the current step, alpha is the fraction of the step.
+		__forceinline Math::Vector2 get_interpolated_center(const float alpha) const;
 	protected:
 		object(
 			const std::wstring& name, 
@@ -68,6 +135,10 @@ namespace Fortress::Abstract
 	private:
 		float m_mass;
 		bool m_bActive;
+		Math::Vector2 m_previous_position;
+		ObjectHandle m_handle;
+
+		friend class ObjectBase::ObjectManager;
 		};
 }
 
@@ -139,7 +210,8 @@ namespace Fortress::Abstract
 		const std::wstring& name, 
 		const Math::Vector2& position, 
 		const Math::Vector2& hitbox,
-		const float mass): entity(name), m_hitbox(hitbox), m_position(position), m_mass(mass), m_bActive(false)
+		const float mass): entity(name), m_hitbox(hitbox), m_position(position), m_mass(mass), m_bActive(false),
+		m_previous_position(position)
 	{
 	}
 
@@ -148,6 +220,16 @@ namespace Fortress::Abstract
 		return m_bActive;
 	}
 
+	inline eObjectTag object::get_object_tag() const
+	{
+		return object_tag;
+	}
+
+	inline ObjectHandle object::get_handle() const
+	{
+		return m_handle;
+	}
+
 	inline void object::set_disabled()
 	{
 		m_bActive = false;
@@ -203,7 +285,22 @@ namespace Fortress::Abstract
 		return m_position;
 	}
 
-	inline std::vector<Math::Vector2> object::get_all_hit_points() const
+	inline void object::store_previous_position()
+	{
+		m_previous_position = m_position;
+	}
+
+	inline Math::Vector2 object::get_previous_center() const
+	{
+		return m_previous_position;
+	}
+
+	inline Math::Vector2 object::get_interpolated_center(const float alpha) const
+	{
+		return m_previous_position + (m_position - m_previous_position) * alpha;
+	}
+
+	inline std::array<Math::Vector2, 10> object::get_all_hit_points() const
 	{
 		return {
 			get_center(), get_top(), get_bottom(), get_left(), get_right(), get_top_left(), get_top_right(),
@@ -245,26 +342,26 @@ namespace Fortress::Abstract
 
 	inline Math::Vector2 object::get_nearest_point(const Math::Vector2& other) const
 	{
-		std::vector<std::pair<float, Math::Vector2>> distances = 
+		const std::array<Math::Vector2, 8> points =
 		{
-			std::make_pair((other - get_top()).magnitude(), get_top()),
-			std::make_pair((other - get_bottom()).magnitude(), get_bottom()),
-			std::make_pair((other - get_left()).magnitude(), get_left()),
-			std::make_pair((other - get_right()).magnitude(), get_right()),
-			std::make_pair((other - get_top_left()).magnitude(), get_top_left()),
-			std::make_pair((other - get_top_right()).magnitude(), get_top_right()),
-			std::make_pair((other - get_bottom_left()).magnitude(), get_bottom_left()),
-			std::make_pair((other - get_bottom_right()).magnitude(), get_bottom_right()),
+			get_top(), get_bottom(), get_left(), get_right(),
+			get_top_left(), get_top_right(), get_bottom_left(), get_bottom_right()
 		};
 
-		std::sort(distances.begin(), distances.end(), [](
-			const std::pair<float, Math::Vector2>& left,
-			const std::pair<float, Math::Vector2>& right)
+		// first of the nearest points is taken, same as the stable order of the candidates.
+		Math::Vector2 nearest = points[0];
+		float nearest_distance = (other - points[0]).magnitude();
+
+		for(size_t i = 1; i < points.size(); ++i)
+		{
+			if(const float distance = (other - points[i]).magnitude(); distance < nearest_distance)
 			{
-				return left.first < right.first;
-			});
+				nearest_distance = distance;
+				nearest = points[i];
+			}
+		}
 
-		return (*distances.begin()).second;
+		return nearest;
 	}
 
 	inline float object::get_mass() const
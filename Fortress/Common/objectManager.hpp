@@ -1,45 +1,239 @@
 #ifndef OBJECTMANAGER_HPP
 #define OBJECTMANAGER_HPP
+#include <array>
+#include <exception>
+#include <type_traits>
+#include <vector>
+
 #include "object.hpp"
 
 namespace Fortress::ObjectBase
 {
+	/**
+	 * \brief Owns the objects in the slots, and hands out the generational handles of them. the raw pointers of the
+	 * live objects are packed per tag, so the objects of a type are visited without locking any pointer.
+	 */
 	class ObjectManager
 	{
 	public:
 		template <typename T, typename... Args>
 		static std::weak_ptr<T> create_object(Args ... args);
 		static void remove_object(const std::weak_ptr<Abstract::object>& obj);
+		static void remove_object(const Abstract::ObjectHandle& handle);
+		// released objects are kept alive until here, the handles are invalid from the removal.
+		static void flush();
 		static void cleanup();
 
+		// nullptr if the handle is stale or the object is not T.
+		template <typename T = Abstract::object>
+		static T* find(const Abstract::ObjectHandle& handle);
+		// for the code that is still on the shared ownership.
+		static std::weak_ptr<Abstract::object> find_weak(const Abstract::ObjectHandle& handle);
+		// calls function(T&) for each live object of the tag of T, the function may remove the object it is given.
+		template <typename T, typename Function>
+		static void for_each(const Function& function);
+
 	private:
-		inline static std::vector<std::shared_ptr<Abstract::object>> m_objects = {};
+		struct Slot
+		{
+			std::shared_ptr<Abstract::object> ptr;
+			Abstract::object* raw = nullptr;
+			uint32_t generation = 1;
+			uint32_t dense = 0;
+			Abstract::eObjectTag tag = Abstract::eObjectTag::None;
+		};
+
+		static constexpr size_t tag_count = static_cast<size_t>(Abstract::eObjectTag::_END);
+
+		static Slot* find_slot(const Abstract::ObjectHandle& handle);
+
+		inline static std::vector<Slot> m_slots = {};
+		inline static std::vector<uint32_t> m_free_slots = {};
+		// objects of the tag i are m_dense[i], and m_dense_slots[i] is the slot of each of them.
+		inline static std::array<std::vector<Abstract::object*>, tag_count> m_dense = {};
+		inline static std::array<std::vector<uint32_t>, tag_count> m_dense_slots = {};
+		inline static std::vector<std::shared_ptr<Abstract::object>> m_released = {};
 	};
 
 	template<typename T, typename... Args>
 	inline std::weak_ptr<T> ObjectManager::create_object(Args... args)
 	{
-		m_objects.push_back(std::make_shared<T>(args...));
-		return std::dynamic_pointer_cast<T>(m_objects.back());
+		static_assert(std::is_base_of_v<Abstract::object, T>);
+
+		const auto created = std::make_shared<T>(args...);
+		uint32_t index;
+
+		if(!m_free_slots.empty())
+		{
+			index = m_free_slots.back();
+			m_free_slots.pop_back();
+		}
+		else
+		{
+			// the next index would alias the slot 0 in the handle.
+			if(m_slots.size() > Abstract::ObjectHandle::index_mask)
+			{
+				throw std::exception("Object slots are exhausted.");
+			}
+
+			index = static_cast<uint32_t>(m_slots.size());
+			m_slots.emplace_back();
+		}
+
+		Slot& slot = m_slots[index];
+		const auto tag_index = static_cast<size_t>(T::object_tag);
+
+		slot.ptr = created;
+		slot.raw = created.get();
+		slot.tag = T::object_tag;
+		slot.dense = static_cast<uint32_t>(m_dense[tag_index].size());
+		m_dense[tag_index].push_back(slot.raw);
+		m_dense_slots[tag_index].push_back(index);
+
+		created->m_handle.value = (slot.generation << Abstract::ObjectHandle::index_bits) | index;
+
+		return created;
 	}
 
 	inline void ObjectManager::remove_object(const std::weak_ptr<Abstract::object>& obj)
 	{
-		m_objects.erase(
-			std::remove_if(m_objects.begin(), m_objects.end(), [obj]
-			(const std::shared_ptr<Abstract::object>& v_obj)
-			{
-				return v_obj == obj.lock();
-			}),
-			m_objects.end());
+		if(const auto ptr = obj.lock())
+		{
+			remove_object(ptr->get_handle());
+		}
+	}
+
+	inline void ObjectManager::remove_object(const Abstract::ObjectHandle& handle)
+	{
+		Slot* slot = find_slot(handle);
+
+		if(!slot)
+		{
+			return;
+		}
+
+		const auto tag_index = static_cast<size_t>(slot->tag);
+		auto& dense = m_dense[tag_index];
+		auto& dense_slots = m_dense_slots[tag_index];
+
+		// last one of the tag takes the place.
+		dense[slot->dense] = dense.back();
+		dense_slots[slot->dense] = dense_slots.back();
+		m_slots[dense_slots[slot->dense]].dense = slot->dense;
+		dense.pop_back();
+		dense_slots.pop_back();
+
+		slot->raw->m_handle = {};
+		m_released.push_back(std::move(slot->ptr));
+		slot->raw = nullptr;
+		slot->tag = Abstract::eObjectTag::None;
+		slot->generation = (slot->generation + 1) & (0xFFFFFFFFu >> Abstract::ObjectHandle::index_bits);
+
+		if(slot->generation == 0)
+		{
+			slot->generation = 1;
+		}
+
+		m_free_slots.push_back(handle.get_index());
+	}
+
+	inline void ObjectManager::flush()
+	{
+		// destructors may release more objects, e.g. the projectile pool of a character.
+		while(!m_released.empty())
+		{
+			const auto released = std::move(m_released);
+			m_released = {};
+		}
 	}
 
 	inline void ObjectManager::cleanup()
 	{
-		for(auto& object : m_objects)
+		// same as the removal, so the slots are freed and the handles of the previous scene are stale.
+		for(auto& slot : m_slots)
 		{
-			object.reset();
+			if(slot.raw)
+			{
+				remove_object(slot.raw->get_handle());
+			}
 		}
+
+		flush();
+	}
+
+	template <typename T>
+	T* ObjectManager::find(const Abstract::ObjectHandle& handle)
+	{
+		Slot* slot = find_slot(handle);
+
+		if(!slot)
+		{
+			return nullptr;
+		}
+
+		if constexpr (std::is_same_v<T, Abstract::object>)
+		{
+			return slot->raw;
+		}
+		else
+		{
+			return dynamic_cast<T*>(slot->raw);
+		}
+	}
+
+	inline std::weak_ptr<Abstract::object> ObjectManager::find_weak(const Abstract::ObjectHandle& handle)
+	{
+		if(const Slot* slot = find_slot(handle))
+		{
+			return slot->ptr;
+		}
+
+		return {};
+	}
+
+	template <typename T, typename Function>
+	void ObjectManager::for_each(const Function& function)
+	{
+		// visited from the back, so the removal of the given object moves the visited last one into its place.
+		// objects created in the function are not visited.
+		auto& dense = m_dense[static_cast<size_t>(T::object_tag)];
+
+		for(size_t i = dense.size(); i-- > 0;)
+		{
+			if(i >= dense.size())
+			{
+				// several objects are removed by the function.
+				continue;
+			}
+
+			if constexpr (std::is_same_v<T, Abstract::object>)
+			{
+				function(*dense[i]);
+			}
+			else if(T* cast = dynamic_cast<T*>(dense[i]))
+			{
+				function(*cast);
+			}
+		}
+	}
+
+	inline ObjectManager::Slot* ObjectManager::find_slot(const Abstract::ObjectHandle& handle)
+	{
+		const uint32_t index = handle.get_index();
+
+		if(!handle.is_valid() || index >= m_slots.size())
+		{
+			return nullptr;
+		}
+
+		Slot& slot = m_slots[index];
+
+		if(!slot.raw || slot.generation != handle.get_generation())
+		{
+			return nullptr;
+		}
+
+		return &slot;
 	}
 }
 #endif // OBJECTMANAGER_HPP
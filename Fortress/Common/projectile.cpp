@@ -12,25 +12,75 @@ namespace Fortress::ObjectBase
 	void projectile::update()
 	{
 		rigidBody::update();
+		// bodies are moved by the integration of the scene, after the update.
+		sweep_ground(get_previous_center());
 		ProjectileController::update();
 	}
 
-	void projectile::on_collision(const CollisionCode& collision, const GlobalPosition& collision_point, const std::weak_ptr<Abstract::rigidBody>& other)
+	void projectile::sweep_ground(const GlobalPosition& sweep_origin)
 	{
-		if(const auto prj = other.lock()->downcast_from_this<projectile>())
+		if(!is_active() || 
+			(get_state() != eProjectileState::Fire && get_state() != eProjectileState::Flying) ||
+			get_max_hit_count() <= get_hit_count())
 		{
 			return;
 		}
 
-		if(const auto ground = other.lock()->downcast_from_this<Object::Ground>())
+		if (const auto scene = Scene::SceneManager::get_active_scene().lock())
 		{
-			if (get_max_hit_count() > get_hit_count() &&
-				ground->safe_is_projectile_hit(collision_point, rigidBody::downcast_from_this<projectile>()))
+			std::shared_ptr<Object::Ground> hit_ground;
+			GlobalPosition hit_position = Math::vector_inf;
+			float nearest = INFINITY;
+
+			// finds the first solid pixel between the last position and the current position.
+			for(const auto& ptr : scene->get_registry<Object::Ground>())
 			{
+				if(const auto ground = ptr.lock())
+				{
+					if(!ground->is_active())
+					{
+						continue;
+					}
+
+					const auto hit = ground->safe_ray_cast_global(sweep_origin, get_center());
+
+					if(hit == Math::vector_inf)
+					{
+						continue;
+					}
+
+					const float distance = (hit - sweep_origin).magnitude();
+
+					if(distance < nearest)
+					{
+						nearest = distance;
+						hit_position = hit;
+						hit_ground = ground;
+					}
+				}
+			}
+
+			if(hit_ground)
+			{
+				m_position = hit_position;
 				notify_ground_hit();
-				ground->safe_set_destroyed_global(collision_point, get_radius());
+				hit_ground->queue_crater_global(hit_position, get_radius());
 			}
 		}
+	}
+
+	void projectile::on_collision(const CollisionCode& collision, const GlobalPosition& collision_point, const std::weak_ptr<Abstract::rigidBody>& other)
+	{
+		if(const auto prj = other.lock()->downcast_from_this<projectile>())
+		{
+			return;
+		}
+
+		// ground is handled by sweep_ground.
+		if(other.lock()->downcast_from_this<Object::Ground>())
+		{
+			return;
+		}
 
 		if(const auto ch  = other.lock()->downcast_from_this<character>())
 		{
@@ -67,6 +117,11 @@ namespace Fortress::ObjectBase
 		rigidBody::render();
 	}
 
+	Abstract::eObjectTag projectile::get_object_tag() const
+	{
+		return object_tag;
+	}
+
 	void projectile::prerender()
 	{
 		ProjectileController::prerender();
@@ -109,7 +164,8 @@ namespace Fortress::ObjectBase
 			m_damage(damage),
 			m_radius(radius),
 			m_armor_penetration(armor_penetration),
-			m_wind_acceleration()
+			m_wind_acceleration(),
+			m_base_speed(speed)
 	{
 	}
 
@@ -134,23 +190,23 @@ namespace Fortress::ObjectBase
 	{
 		if (const auto scene = Scene::SceneManager::get_active_scene().lock())
 		{
-			const auto characters = scene->is_in_range_nearest<character>(
-				rigidBody::downcast_from_this<object>(), get_radius());
-			const auto grounds = scene->get_objects<Object::Ground>();
+			Abstract::NearestBuffer<character, splash_max_characters> characters;
+			scene->is_in_range_nearest(rigidBody::downcast_from_this<object>(), get_radius(), characters);
+			const auto& grounds = scene->get_registry<Object::Ground>();
 
 			for(const auto& ptr : grounds)
 			{
 				if (const auto ground = ptr.lock())
 				{
-					ground->safe_set_destroyed_global(get_center(), get_radius());
+					ground->queue_crater_global(get_center(), get_radius());
 				}
 			}
 
-			for (const auto& [ptr, near_pair] : characters)
+			for (const auto& [ptr, key, distance, point] : characters)
 			{
 				if (const auto character = ptr.lock())
 				{
-					character->hit(rigidBody::downcast_from_this<projectile>(), near_pair.second);
+					character->hit(rigidBody::downcast_from_this<projectile>(), point);
 				}
 			}
 		}
@@ -174,8 +230,10 @@ namespace Fortress::ObjectBase
 		const Math::Vector2& velocity,
 		const float charged)
 	{
-		set_speed(get_speed() * charged);
+		set_speed(m_base_speed * charged);
 		m_position = position;
+		// not swept from where it was left.
+		store_previous_position();
 
 		if(const auto battle_scene = 
 			std::dynamic_pointer_cast<Scene::BattleScene>(Scene::SceneManager::get_active_scene().lock()))
@@ -187,4 +245,14 @@ namespace Fortress::ObjectBase
 
 		m_velocity = velocity;
 	}
+
+	void projectile::reset(const unsigned int id)
+	{
+		reset_current_gravity_speed();
+		reset_current_speed();
+		set_speed(m_base_speed);
+		m_velocity = {};
+		m_wind_acceleration = {};
+		ProjectileController::reset(id);
+	}
 }
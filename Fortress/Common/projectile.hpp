@@ -9,10 +9,14 @@
 namespace Fortress::ObjectBase
 {
 	constexpr float default_explosion_radius = 10.0f;
+	// a room has 15 players at most.
+	constexpr size_t splash_max_characters = 16;
 
 	class projectile : public Abstract::rigidBody, public Controller::ProjectileController
 	{
 	public:
+		static constexpr Abstract::eObjectTag object_tag = Abstract::eObjectTag::Projectile;
+
 		projectile() = delete;
 		projectile& operator=(const projectile& other) = default;
 		projectile& operator=(projectile&& other) = default;
@@ -22,6 +26,7 @@ namespace Fortress::ObjectBase
 
 		void initialize() override;
 		void update() override;
+		Abstract::eObjectTag get_object_tag() const override;
 		void render() override;
 		void prerender() override;
 
@@ -31,6 +36,8 @@ namespace Fortress::ObjectBase
 			const std::weak_ptr<rigidBody>& other) override;
 
 		virtual void fire(const Math::Vector2& position, const Math::Vector2& velocity, const float charged);
+		// brings the pooled projectile back to the state of the creation, before the next fire.
+		void reset(const unsigned int id);
 
 		float get_radius() const;
 		float get_damage() const;
@@ -61,11 +68,16 @@ namespace Fortress::ObjectBase
 		void destroyed() override;
 
 	private:
+		// continuous collision check with the grounds for the movement of this frame.
+		void sweep_ground(const GlobalPosition& sweep_origin);
+
 		float m_damage;
 		float m_radius;
 		float m_armor_penetration;
 
 		Math::Vector2 m_wind_acceleration;
+		// speed of the creation, fire scales it by the charge.
+		Math::Vector2 m_base_speed;
 	};
 }
 #endif // PROJECTILE_HPP
@@ -1,6 +1,9 @@
 #include "pch.h"
 #include "rigidBody.hpp"
 
+#include <algorithm>
+
+#include "CollisionQueue.hpp"
 #include "debug.hpp"
 #include "deltatime.hpp"
 #include "math.h"
@@ -37,62 +40,84 @@ namespace Fortress::Abstract
 			return;
 		}
 
-		bool collided = false;
+		const auto scene = Scene::SceneManager::get_active_scene().lock();
+		const auto objectified_this = std::dynamic_pointer_cast<object>(shared_from_this());
+		CollisionQueue& collisions = scene->get_collisions();
+
+		collisions.add_body(downcast_from_this<rigidBody>());
 
-		// gets the objects from active scene.
-		for (const auto& right_r : Scene::SceneManager::get_active_scene().lock()->get_objects())
+		// contacts are kept by the scene, a body without any contact skips the narrowphase, and a contact whose
+		// boxes are same as the last test takes the result of it.
+		scene->get_contacts().for_each_contact(
+			this, [&](const std::weak_ptr<object>& right_r, const eContactEvent event, ContactCache& cache)
 		{
-			// @todo: performance degrading. objects could contain others.
+			const bool was_touching = cache.valid && cache.code != CollisionCode::None;
+
+			if (event == eContactEvent::Exit)
+			{
+				if (was_touching)
+				{
+					collisions.exit(downcast_from_this<rigidBody>());
+				}
+
+				return;
+			}
+
 			// check if object is rigid body.
 			const auto locked_ptr = right_r.lock();
 			std::shared_ptr rb = std::dynamic_pointer_cast<rigidBody>(locked_ptr);
 
 			if (!rb || shared_from_this() == locked_ptr || !this->is_active() || !rb->is_active())
 			{
-				continue;
+				return;
 			}
 
-			const auto objectified_this = std::dynamic_pointer_cast<object>(shared_from_this());
-
-			// check collsion.
-			CollisionCode code = is_collision(objectified_this, locked_ptr);
+			const bool unchanged = cache.valid &&
+				cache.top_left == get_top_left() && cache.bottom_right == get_bottom_right() &&
+				cache.other_top_left == rb->get_top_left() && cache.other_bottom_right == rb->get_bottom_right();
 
-			if(code != CollisionCode::None)
+			if (!unchanged)
 			{
-				// @todo: verification is needed.
-				// sorts out small to big
-				const rigidBody* small_object = 
-					m_hitbox.magnitude() <= rb->m_hitbox.magnitude() ? this : rb.get();
-				const rigidBody* big_object = small_object == this ? rb.get() : this;
-
-				// gets the direction vector for position.
-				const DirVector dir = (small_object->get_center() - big_object->get_center()).normalized();
-
-				// if left object intersects with right from top left, then the direction will be
-				// top left from center. plus, hitbox needs to be considered for the nearest position.
-				// if the object collided, at least, two objects meet each other, in range of hitbox.
-				// for that, reverse the direction to get the hitbox included value, which is, in above
-				// example, bottom right.
-				const eDirVector eDir = Math::Vector2::to_dir_enum(-dir);
-				GlobalPosition collision_point = small_object->get_dir_point(eDir);
-
-				collided = true;
-				on_collision(code, collision_point, rb);
+				cache.top_left = get_top_left();
+				cache.bottom_right = get_bottom_right();
+				cache.other_top_left = rb->get_top_left();
+				cache.other_bottom_right = rb->get_bottom_right();
+				cache.valid = true;
+
+				// check collsion.
+				cache.code = is_collision(objectified_this, locked_ptr);
+
+				if(cache.code != CollisionCode::None)
+				{
+					// @todo: verification is needed.
+					// sorts out small to big
+					const rigidBody* small_object = 
+						m_hitbox.magnitude() <= rb->m_hitbox.magnitude() ? this : rb.get();
+					const rigidBody* big_object = small_object == this ? rb.get() : this;
+
+					// gets the direction vector for position.
+					const DirVector dir = (small_object->get_center() - big_object->get_center()).normalized();
+
+					// if left object intersects with right from top left, then the direction will be
+					// top left from center. plus, hitbox needs to be considered for the nearest position.
+					// if the object collided, at least, two objects meet each other, in range of hitbox.
+					// for that, reverse the direction to get the hitbox included value, which is, in above
+					// example, bottom right.
+					const eDirVector eDir = Math::Vector2::to_dir_enum(-dir);
+					cache.point = small_object->get_dir_point(eDir);
+				}
 			}
-		}
-
-		if(!collided)
-		{
-			on_nocollison();
-		}
-
-		move();
 
-		// if object is affected by gravity...
-		if(m_bGravity)
-		{
-			apply_gravity();
-		}
+			if(cache.code != CollisionCode::None)
+			{
+				// handlers are called after every body is tested, by the scene.
+				collisions.push(downcast_from_this<rigidBody>(), rb, cache.code, cache.point);
+			}
+			else if(was_touching)
+			{
+				collisions.exit(downcast_from_this<rigidBody>());
+			}
+		});
 	}
 
 	void rigidBody::render()
@@ -361,7 +386,7 @@ namespace Fortress::Abstract
 		m_speed = speed;
 	}
 
-	Math::Vector2 rigidBody::get_speed()
+	Math::Vector2 rigidBody::get_speed() const
 	{
 		return m_speed;
 	}
@@ -371,50 +396,39 @@ namespace Fortress::Abstract
 		m_hitbox = hitbox;
 	}
 
-	void rigidBody::apply_gravity()
+	void rigidBody::move()
 	{
-		// free-falling
-		const Math::Vector2 diff = get_bottom() - Math::Vector2{
-			0.0f, static_cast<float>(EngineHandle::get_handle().lock()->get_actual_max_y())
-		};
-
-		if (diff.abs().get_y() <= Math::epsilon)
-		{
-			m_gravity_speed = 0.0f;
-			return;
-		}
-
-		if (m_gravity_speed <= max_gravity_speed) 
-		{
-			m_gravity_speed += m_gravity_acceleration * DeltaTime::get_deltaTime() * 0.5f;
-			*this += {0.0f, m_gravity_speed * DeltaTime::get_deltaTime()};
-			m_gravity_speed += m_gravity_acceleration * DeltaTime::get_deltaTime() * 0.5f;
-		}
+		// integrated with the gravity by the scene after all bodies are updated.
+		PhysicsStore::write(
+			m_physics.get(), this,
+			{
+				m_position,
+				m_velocity,
+				m_speed,
+				m_curr_speed,
+				m_acceleration,
+				m_hitbox.get_y() / 2,
+				m_gravity_speed,
+				m_gravity_acceleration,
+				m_bGravity
+			});
 	}
 
-	void rigidBody::move()
+	void rigidBody::modify_current_speed(const AccelVector& speed)
 	{
-		if (m_curr_speed.magnitude() < Math::epsilon)
-		{
-			m_curr_speed = m_speed;
-		}
+		const DirVector dir = speed.x_dir();
 
-		if (m_velocity == Math::Vector2{0.0f, 0.0f})
+		if(PhysicsStore::is_fixed_point())
 		{
-			reset_current_speed();
+			// wind goes to the integration, kept in the fixed-point as well.
+			const auto delta = Math::FixedVector2::from_vector2(speed.abs()) *
+				Math::Fixed::from_float(DeltaTime::get_deltaTime());
+			const auto current = Math::FixedVector2::from_vector2(m_curr_speed);
+
+			m_curr_speed = (get_velocity_offset() == dir ? current + delta : current - delta).to_vector2();
 			return;
 		}
 
-		//@todo: friction.
-		m_curr_speed += m_acceleration * DeltaTime::get_deltaTime() * 0.5f;
-		*this += m_velocity * m_curr_speed * DeltaTime::get_deltaTime();
-		m_curr_speed += m_acceleration * DeltaTime::get_deltaTime() * 0.5f;
-	}
-
-	void rigidBody::modify_current_speed(const AccelVector& speed)
-	{
-		const DirVector dir = speed.x_dir();
-
 		if(get_velocity_offset() == dir)
 		{
 			m_curr_speed += speed.abs() * DeltaTime::get_deltaTime();
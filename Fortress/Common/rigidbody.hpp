@@ -4,12 +4,11 @@
 
 #include <string>
 #include "object.hpp"
+#include "PhysicsStore.hpp"
 #include "Texture.hpp"
 
 namespace Fortress::Abstract
 {
-	constexpr float max_gravity_speed = 1000000000.0f;
-
 	class rigidBody : public object
 	{
 	public:
@@ -39,7 +38,7 @@ namespace Fortress::Abstract
 		static CollisionCode is_collision(const std::weak_ptr<object>& left, const std::weak_ptr<object>& right) noexcept;
 
 		void set_speed(const Math::Vector2& speed);
-		Math::Vector2 get_speed();
+		Math::Vector2 get_speed() const;
 		virtual void set_hitbox(const Math::Vector2& hitbox);
 
 		void move_down() override;
@@ -77,8 +76,12 @@ namespace Fortress::Abstract
 		bool m_bGravity{};
 
 		Math::Vector2 m_offset;
+		PhysicsHandle m_physics;
+		// index in the collision queue of this frame, -1 if it is not queued.
+		int m_collision_index = -1;
 
-		void apply_gravity();
+		friend class PhysicsStore;
+		friend class CollisionQueue;
 
 	protected:
 		rigidBody(
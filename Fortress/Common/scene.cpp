@@ -0,0 +1,28 @@
+#include "pch.h"
+#include "scene.hpp"
+
+#include "character.hpp"
+#include "ground.hpp"
+#include "projectile.hpp"
+
+namespace Fortress::Abstract
+{
+	void scene::add_to_registry(const std::shared_ptr<object>& obj)
+	{
+		// tag is given by the most derived type, so the cast always succeeds.
+		switch(obj->get_object_tag())
+		{
+		case eObjectTag::Character:
+			m_character_registry.push_back(std::static_pointer_cast<ObjectBase::character>(obj));
+			break;
+		case eObjectTag::Projectile:
+			m_projectile_registry.push_back(std::static_pointer_cast<ObjectBase::projectile>(obj));
+			break;
+		case eObjectTag::Ground:
+			m_ground_registry.push_back(std::static_pointer_cast<Object::Ground>(obj));
+			break;
+		default:
+			break;
+		}
+	}
+}
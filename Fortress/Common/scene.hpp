@@ -1,13 +1,20 @@
 #pragma once
 #ifndef SCENE_HPP
 #define SCENE_HPP
+#include <array>
+#include <memory_resource>
+#include <type_traits>
 #include <vector>
 
 #include "camera.hpp"
 #include "cameraManager.hpp"
+#include "CollisionQueue.hpp"
 #include "entity.hpp"
 #include "layer.hpp"
 #include "objectManager.hpp"
+#include "PhysicsStore.hpp"
+#include "SweepAndPrune.hpp"
+#include "UniformGrid.hpp"
 
 namespace Fortress
 {
@@ -15,10 +22,49 @@ namespace Fortress
 	{
 		struct weakPointerComparer;
 	}
+
+	namespace ObjectBase
+	{
+		class character;
+		class projectile;
+	}
+
+	namespace Object
+	{
+		class Ground;
+	}
 }
 
 namespace Fortress::Abstract
 {
+	// nearest objects of a query, kept in the place of the caller. the farthest is dropped if it is full.
+	template <class T, size_t N>
+	class NearestBuffer
+	{
+	public:
+		struct Hit
+		{
+			std::weak_ptr<T> ptr;
+			// identifies the object without locking the pointer.
+			const T* key;
+			float distance;
+			Math::Vector2 point;
+		};
+
+		void clear();
+		void insert(const std::shared_ptr<T>& ptr, float distance, const Math::Vector2& point);
+
+		bool empty() const;
+		size_t size() const;
+		const Hit* begin() const;
+		const Hit* end() const;
+		const Hit& operator[](size_t index) const;
+
+	private:
+		std::array<Hit, N> m_hits{};
+		size_t m_count = 0;
+	};
+
 	class scene : public entity
 	{
 	public:
@@ -33,23 +79,78 @@ namespace Fortress::Abstract
 
 		template <class T>
 		std::vector<std::weak_ptr<T>> is_in_range(const Math::Vector2& mid_point, float radius);
+		// same as above, allocated from the given resource, e.g. the frame arena.
+		template <class T>
+		std::pmr::vector<std::weak_ptr<T>> is_in_range(
+			const Math::Vector2& mid_point, float radius, std::pmr::memory_resource* resource);
 		template <class T>
 		std::vector<std::pair<std::weak_ptr<T>, std::pair<float, Math::Vector2>>> is_in_range_nearest(
 			const std::weak_ptr<object>& pivot, float radius);
-
-		void add_game_object(LayerType layer_type, const std::weak_ptr<object>& obj);
+		// ranked by the distance to the position of the object as the vector one, the objects are in range if the nearest
+		// point is. the point of the hit is the nearest point.
+		template <class T, size_t N>
+		void is_in_range(const Math::Vector2& mid_point, float radius, NearestBuffer<T, N>& out);
+		// distance is the smallest one between the hit points of the pivot and the nearest points of the object.
+		template <class T, size_t N>
+		void is_in_range_nearest(const std::weak_ptr<object>& pivot, float radius, NearestBuffer<T, N>& out);
+
+		// registry is chosen by the tag of the most derived type, regardless of the type of the given pointer.
+		template <class T>
+		void add_game_object(LayerType layer_type, const std::shared_ptr<T>& obj);
+		template <class T>
+		void add_game_object(LayerType layer_type, const std::weak_ptr<T>& obj);
 		void remove_game_object(LayerType layer_type, const std::weak_ptr<object>& obj);
+		// removes from the scene, but the object manager keeps it.
+		void detach_game_object(LayerType layer_type, const std::weak_ptr<object>& obj);
 
 		template <class T>
 		std::vector<std::weak_ptr<T>> get_objects();
+		// objects of the tag of T in the order of the addition, T should be the type that declares the tag.
+		template <class T>
+		const std::vector<std::weak_ptr<T>>& get_registry();
 		std::weak_ptr<Camera> get_camera();
 
 		std::vector<std::weak_ptr<object>> get_objects();
+		// copies are allocated from the given resource, e.g. the frame arena.
+		template <class T>
+		std::pmr::vector<std::weak_ptr<T>> get_objects(std::pmr::memory_resource* resource);
+		std::pmr::vector<std::weak_ptr<object>> get_objects(std::pmr::memory_resource* resource);
+		// boxes of this frame bucketed by the cells.
+		const UniformGrid& get_broadphase() const;
+		// persistent contacts of the fattened boxes, kept between the frames.
+		const SweepAndPrune& get_contacts() const;
+		// collisions of the narrowphase, dispatched after the layers are updated.
+		CollisionQueue& get_collisions();
 
 	private:
+		void update_broadphase();
+		// defined along the registered types, which are incomplete here.
+		void add_to_registry(const std::shared_ptr<object>& obj);
+
+		template <class T>
+		auto& registry_of();
+		// calls function(const std::shared_ptr<T>&) for each object of T, without the scan if T has the tag.
+		template <class T, typename Function>
+		void for_each_object(const Function& function);
+		// calls function(const std::shared_ptr<T>&) for each active object of T which may overlap the box.
+		template <class T, typename Function>
+		void for_each_indexed(const Math::Vector2& top_left, const Math::Vector2& bottom_right, const Function& function);
+		// active objects of T within the radius, sorted by the distance of the positions.
+		template <class T, class Container>
+		void collect_in_range(const Math::Vector2& mid_point, float radius, Container& ret);
+
 		std::weak_ptr<Camera> m_camera;
 		std::vector<std::weak_ptr<object>> m_objects{};
 		std::vector<Layer> m_layers;
+		UniformGrid m_broadphase;
+		SweepAndPrune m_contacts;
+		CollisionQueue m_collisions;
+
+		std::vector<std::weak_ptr<ObjectBase::character>> m_character_registry;
+		std::vector<std::weak_ptr<ObjectBase::projectile>> m_projectile_registry;
+		std::vector<std::weak_ptr<Object::Ground>> m_ground_registry;
+		// added after the broadphase of this frame is built.
+		std::vector<std::weak_ptr<object>> m_unindexed;
 
 		struct weakPointerComparer {
 		    bool operator() (
@@ -70,15 +171,40 @@ namespace Fortress::Abstract
 		return m_objects;
 	}
 
-	inline void scene::add_game_object(LayerType layer_type, const std::weak_ptr<object>& obj)
+	inline std::pmr::vector<std::weak_ptr<object>> scene::get_objects(std::pmr::memory_resource* resource)
+	{
+		return {m_objects.begin(), m_objects.end(), resource};
+	}
+
+	template <class T>
+	void scene::add_game_object(LayerType layer_type, const std::shared_ptr<T>& obj)
 	{
+		static_assert(std::is_base_of_v<object, T>);
+
 		m_layers[static_cast<unsigned int>(layer_type)].add_game_object(obj);
 		m_objects.push_back(obj);
+		m_unindexed.push_back(obj);
+		add_to_registry(obj);
+	}
+
+	template <class T>
+	void scene::add_game_object(LayerType layer_type, const std::weak_ptr<T>& obj)
+	{
+		if(const auto ptr = obj.lock())
+		{
+			add_game_object(layer_type, ptr);
+		}
 	}
 
 	inline void scene::remove_game_object(LayerType layer_type, const std::weak_ptr<object>& obj)
 	{
+		// layer finds the object by the handle, which is invalidated by the removal.
+		detach_game_object(layer_type, obj);
 		ObjectBase::ObjectManager::remove_object(obj);
+	}
+
+	inline void scene::detach_game_object(LayerType layer_type, const std::weak_ptr<object>& obj)
+	{
 		m_layers[static_cast<unsigned int>(layer_type)].remove_game_object(obj);
 		m_objects.erase(
 			std::remove_if(m_objects.begin(), m_objects.end(),
@@ -87,6 +213,22 @@ namespace Fortress::Abstract
 				return p.lock() == obj.lock();
 			}),
 			m_objects.end());
+
+		// same object shares the owner regardless of the type, so the types can be incomplete.
+		const auto remove_from = [&obj](auto& registry)
+		{
+			registry.erase(
+				std::remove_if(registry.begin(), registry.end(), [&obj](const auto& p)
+				{
+					return p.expired() || (!p.owner_before(obj) && !obj.owner_before(p));
+				}),
+				registry.end());
+		};
+
+		remove_from(m_character_registry);
+		remove_from(m_projectile_registry);
+		remove_from(m_ground_registry);
+		remove_from(m_unindexed);
 	}
 
 	inline std::weak_ptr<Camera> scene::get_camera()
@@ -94,6 +236,41 @@ namespace Fortress::Abstract
 		return m_camera;
 	}
 
+	inline const UniformGrid& scene::get_broadphase() const
+	{
+		return m_broadphase;
+	}
+
+	inline const SweepAndPrune& scene::get_contacts() const
+	{
+		return m_contacts;
+	}
+
+	inline CollisionQueue& scene::get_collisions()
+	{
+		return m_collisions;
+	}
+
+	inline void scene::update_broadphase()
+	{
+		m_broadphase.clear();
+
+		for(const auto& obj : m_objects)
+		{
+			if(const auto ptr = obj.lock())
+			{
+				if(ptr->is_active())
+				{
+					m_broadphase.insert(ptr);
+				}
+			}
+		}
+
+		m_broadphase.build();
+		m_contacts.update(m_objects);
+		m_unindexed.clear();
+	}
+
 	inline scene::scene(const std::wstring& name):
 		entity(name),
 		m_objects(0)
@@ -126,10 +303,31 @@ namespace Fortress::Abstract
 			ptr->update();
 		}
 
+		update_broadphase();
+
 		for(const auto& l : m_layers)
 		{
 			l.update();
 		}
+
+		m_collisions.dispatch();
+
+		// position before the integration, for the sweep and the render.
+		for(const auto& obj : m_objects)
+		{
+			if(const auto ptr = obj.lock())
+			{
+				ptr->store_previous_position();
+			}
+		}
+
+		// bodies have written their state in the update.
+		PhysicsStore::integrate(
+			DeltaTime::get_deltaTime(),
+			static_cast<float>(EngineHandle::get_handle().lock()->get_actual_max_y()));
+		PhysicsStore::flush();
+		// objects removed in this frame are not referred anymore.
+		ObjectBase::ObjectManager::flush();
 	}
 
 	inline void scene::render()
@@ -161,25 +359,39 @@ namespace Fortress::Abstract
 		const Math::Vector2& mid_point,	const float radius)
 	{
 		std::vector<std::weak_ptr<T>> ret = {};
+		collect_in_range<T>(mid_point, radius, ret);
+		return ret;
+	}
+
+	template <class T>
+	std::pmr::vector<std::weak_ptr<T>> scene::is_in_range(
+		const Math::Vector2& mid_point, const float radius, std::pmr::memory_resource* resource)
+	{
+		std::pmr::vector<std::weak_ptr<T>> ret{resource};
+		collect_in_range<T>(mid_point, radius, ret);
+		return ret;
+	}
 
+	template <class T, class Container>
+	void scene::collect_in_range(const Math::Vector2& mid_point, const float radius, Container& ret)
+	{
 		static_assert(std::is_base_of_v<object, T>);
 
-		for (const auto& obj : m_objects)
+		for_each_object<T>([&](const std::shared_ptr<T>& ptr)
 		{
-			if (const auto ptr = std::dynamic_pointer_cast<T>(obj.lock()))
+			if(!ptr->is_active())
 			{
-				if(ptr->is_active())
-				{
-					const Math::Vector2 local_position = ptr->to_nearest_local_position(mid_point);
-					const float distance = local_position.magnitude();
+				return;
+			}
 
-					if (distance <= radius)
-					{
-						ret.push_back(ptr);
-					}
-				}
+			const Math::Vector2 local_position = ptr->to_nearest_local_position(mid_point);
+			const float distance = local_position.magnitude();
+
+			if (distance <= radius)
+			{
+				ret.push_back(ptr);
 			}
-		}
+		});
 
 		std::sort(
 			ret.begin(), 
@@ -190,8 +402,6 @@ namespace Fortress::Abstract
 			return Math::Vector2(left.lock()->m_position - mid_point).magnitude() <
 				Math::Vector2(right.lock()->m_position - mid_point).magnitude();
 		});
-
-		return ret;
 	}
 
 	template <typename T>
@@ -205,35 +415,32 @@ namespace Fortress::Abstract
 
 		std::map<std::weak_ptr<T>, DistanceVectorPair, weakPointerComparer> map = {};
 		const auto pivot_ptr = pivot.lock();
-		const std::vector<Math::Vector2> compare_list = pivot_ptr->get_all_hit_points();
+		const auto compare_list = pivot_ptr->get_all_hit_points();
 
-		for (const auto& obj : m_objects)
+		for_each_object<T>([&](const std::shared_ptr<T>& ptr)
 		{
-			if (const auto ptr = std::dynamic_pointer_cast<T>(obj.lock()))
+			if(!ptr->is_active())
 			{
-				if(!ptr->is_active())
-				{
-					continue;
-				}
+				return;
+			}
 
-				for(const auto& point : compare_list)
-				{
-					const Math::Vector2 local_position = ptr->to_nearest_local_position(point);
-					const float distance = local_position.magnitude();
+			for(const auto& point : compare_list)
+			{
+				const Math::Vector2 local_position = ptr->to_nearest_local_position(point);
+				const float distance = local_position.magnitude();
 
-					if (distance <= radius)
+				if (distance <= radius)
+				{
+					if(map.find(ptr) != map.end() && map[ptr].first > distance)
 					{
-						if(map.find(ptr) != map.end() && map[ptr].first > distance)
-						{
-							map[ptr] = {distance, ptr->get_nearest_point(point)};
-							continue;
-						}
-
 						map[ptr] = {distance, ptr->get_nearest_point(point)};
+						continue;
 					}
+
+					map[ptr] = {distance, ptr->get_nearest_point(point)};
 				}
 			}
-		}
+		});
 
 		std::vector<MapPair> sorted(map.begin(), map.end());
 		std::sort(sorted.begin(), sorted.end(), []
@@ -245,20 +452,280 @@ namespace Fortress::Abstract
 		return sorted;
 	}
 
+	template <class T, size_t N>
+	void scene::is_in_range(const Math::Vector2& mid_point, const float radius, NearestBuffer<T, N>& out)
+	{
+		static_assert(std::is_base_of_v<object, T>);
+
+		out.clear();
+
+		const Math::Vector2 extent{radius, radius};
+
+		for_each_indexed<T>(mid_point - extent, mid_point + extent, [&](const std::shared_ptr<T>& ptr)
+		{
+			const Math::Vector2 point = ptr->get_nearest_point(mid_point);
+
+			if ((mid_point - point).magnitude() <= radius)
+			{
+				out.insert(ptr, Math::Vector2(ptr->m_position - mid_point).magnitude(), point);
+			}
+		});
+	}
+
+	template <class T, size_t N>
+	void scene::is_in_range_nearest(
+		const std::weak_ptr<object>& pivot, const float radius, NearestBuffer<T, N>& out)
+	{
+		static_assert(std::is_base_of_v<object, T>);
+
+		out.clear();
+
+		const auto pivot_ptr = pivot.lock();
+
+		if(!pivot_ptr)
+		{
+			return;
+		}
+
+		const auto compare_list = pivot_ptr->get_all_hit_points();
+		const Math::Vector2 extent{radius, radius};
+
+		for_each_indexed<T>(
+			pivot_ptr->get_top_left() - extent, 
+			pivot_ptr->get_bottom_right() + extent, 
+			[&](const std::shared_ptr<T>& ptr)
+		{
+			float nearest = INFINITY;
+			Math::Vector2 nearest_point{};
+
+			for(const auto& point : compare_list)
+			{
+				const Math::Vector2 candidate = ptr->get_nearest_point(point);
+				const float distance = (point - candidate).magnitude();
+
+				if (distance < nearest)
+				{
+					nearest = distance;
+					nearest_point = candidate;
+				}
+			}
+
+			if (nearest <= radius)
+			{
+				out.insert(ptr, nearest, nearest_point);
+			}
+		});
+	}
+
 	template <class T>
 	std::vector<std::weak_ptr<T>> scene::get_objects()
 	{
 		std::vector<std::weak_ptr<T>> ret = {};
 
-		for(const auto& obj : m_objects)
+		for_each_object<T>([&ret](const std::shared_ptr<T>& ptr)
+		{
+			ret.push_back(ptr);
+		});
+
+		return ret;
+	}
+
+	template <class T>
+	std::pmr::vector<std::weak_ptr<T>> scene::get_objects(std::pmr::memory_resource* resource)
+	{
+		std::pmr::vector<std::weak_ptr<T>> ret{resource};
+
+		for_each_object<T>([&ret](const std::shared_ptr<T>& ptr)
+		{
+			ret.push_back(ptr);
+		});
+
+		return ret;
+	}
+
+	template <class T>
+	const std::vector<std::weak_ptr<T>>& scene::get_registry()
+	{
+		static_assert(T::object_tag != eObjectTag::None);
+		static_assert(std::is_same_v<
+			typename std::remove_reference_t<decltype(registry_of<T>())>::value_type, std::weak_ptr<T>>);
+
+		return registry_of<T>();
+	}
+
+	template <class T>
+	auto& scene::registry_of()
+	{
+		if constexpr (T::object_tag == eObjectTag::Character)
+		{
+			return m_character_registry;
+		}
+		else if constexpr (T::object_tag == eObjectTag::Projectile)
+		{
+			return m_projectile_registry;
+		}
+		else
+		{
+			static_assert(T::object_tag == eObjectTag::Ground);
+			return m_ground_registry;
+		}
+	}
+
+	template <class T, typename Function>
+	void scene::for_each_indexed(
+		const Math::Vector2& top_left, const Math::Vector2& bottom_right, const Function& function)
+	{
+		const auto visit = [&function](const std::weak_ptr<object>& obj)
 		{
-			if(const auto cast = std::dynamic_pointer_cast<T>(obj.lock()))
+			const auto ptr = obj.lock();
+
+			if(!ptr || !ptr->is_active())
+			{
+				return;
+			}
+
+			if constexpr (T::object_tag != eObjectTag::None)
+			{
+				using Registered = typename std::remove_reference_t<decltype(registry_of<T>())>::value_type::element_type;
+
+				if(ptr->get_object_tag() != T::object_tag)
+				{
+					return;
+				}
+
+				// tag is checked, so the cast is only needed for the derived type of the tag.
+				if constexpr (std::is_same_v<Registered, T>)
+				{
+					function(std::static_pointer_cast<T>(ptr));
+					return;
+				}
+			}
+
+			if(const auto cast = std::dynamic_pointer_cast<T>(ptr))
 			{
-				ret.push_back(cast);
+				function(cast);
 			}
+		};
+
+		m_broadphase.for_each_overlap(top_left, bottom_right, T::object_tag, visit);
+
+		for(const auto& obj : m_unindexed)
+		{
+			visit(obj);
 		}
+	}
 
-		return ret;
+	template <class T, typename Function>
+	void scene::for_each_object(const Function& function)
+	{
+		if constexpr (T::object_tag != eObjectTag::None)
+		{
+			using Registered = typename std::remove_reference_t<decltype(registry_of<T>())>::value_type::element_type;
+
+			for(const auto& obj : registry_of<T>())
+			{
+				const auto ptr = obj.lock();
+
+				if(!ptr)
+				{
+					continue;
+				}
+
+				// derived type of the tag is still checked.
+				if constexpr (std::is_same_v<Registered, T>)
+				{
+					function(ptr);
+				}
+				else if(const auto cast = std::dynamic_pointer_cast<T>(ptr))
+				{
+					function(cast);
+				}
+			}
+		}
+		else
+		{
+			for(const auto& obj : m_objects)
+			{
+				if(const auto ptr = std::dynamic_pointer_cast<T>(obj.lock()))
+				{
+					function(ptr);
+				}
+			}
+		}
+	}
+
+	template <class T, size_t N>
+	void NearestBuffer<T, N>::clear()
+	{
+		m_count = 0;
+	}
+
+	template <class T, size_t N>
+	void NearestBuffer<T, N>::insert(const std::shared_ptr<T>& ptr, const float distance, const Math::Vector2& point)
+	{
+		// object added again in the frame can be found twice, the nearer one is kept.
+		for(size_t i = 0; i < m_count; ++i)
+		{
+			if(m_hits[i].key == ptr.get())
+			{
+				if(m_hits[i].distance <= distance)
+				{
+					return;
+				}
+
+				for(size_t j = i; j + 1 < m_count; ++j)
+				{
+					m_hits[j] = std::move(m_hits[j + 1]);
+				}
+
+				--m_count;
+				break;
+			}
+		}
+
+		if(m_count == N && m_hits[N - 1].distance <= distance)
+		{
+			return;
+		}
+
+		size_t index = m_count < N ? m_count++ : N - 1;
+
+		for(; index > 0 && m_hits[index - 1].distance > distance; --index)
+		{
+			m_hits[index] = std::move(m_hits[index - 1]);
+		}
+
+		m_hits[index] = {ptr, ptr.get(), distance, point};
+	}
+
+	template <class T, size_t N>
+	bool NearestBuffer<T, N>::empty() const
+	{
+		return m_count == 0;
+	}
+
+	template <class T, size_t N>
+	size_t NearestBuffer<T, N>::size() const
+	{
+		return m_count;
+	}
+
+	template <class T, size_t N>
+	const typename NearestBuffer<T, N>::Hit* NearestBuffer<T, N>::begin() const
+	{
+		return m_hits.data();
+	}
+
+	template <class T, size_t N>
+	const typename NearestBuffer<T, N>::Hit* NearestBuffer<T, N>::end() const
+	{
+		return m_hits.data() + m_count;
+	}
+
+	template <class T, size_t N>
+	const typename NearestBuffer<T, N>::Hit& NearestBuffer<T, N>::operator[](const size_t index) const
+	{
+		return m_hits[index];
 	}
 }
 #endif // SCENE_HPP
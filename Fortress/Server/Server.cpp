@@ -3,6 +3,7 @@
 #include <iostream>
 #include <mutex>
 #include <random>
+#include <string_view>
 #include <thread>
 #include <winsock2.h>
 #include <ws2tcpip.h>
@@ -16,6 +17,7 @@
 #include "../Common/deltatime.hpp"
 #include "../Common/sceneManager.hpp"
 #include "../Common/resourceManager.hpp"
+#include "../Common/TrajectoryPredictor.hpp"
 
 #include "ClientSide.hpp"
 
@@ -57,14 +59,26 @@ namespace Fortress::Network::Server
 	static std::default_random_engine e;
 	static std::uniform_real_distribution<float> dis{-50, 50};
 	static float room_wind[15]{0.0f, };
+	// given to the clients at the game start, set by the --fixed-point argument.
+	static bool fixed_point_physics = false;
 
 	static std::map<std::pair<RoomID, PlayerID>, Client> client_list = {};
+	// flights of the fired projectiles, for checking the hit claims.
+	static std::map<std::tuple<RoomID, PlayerID, unsigned int>, ObjectBase::TrajectoryPredictor> fired_projectiles = {};
 
 	int get_wind_acceleration(const RoomID room_id)
 	{
 		return static_cast<int>(room_wind[room_id] / 10.0f) * 10.0f;
 	}
 
+	void clear_fired_projectiles(const RoomID room_id)
+	{
+		for(auto it = fired_projectiles.begin(); it != fired_projectiles.end();)
+		{
+			it = std::get<0>(it->first) == room_id ? fired_projectiles.erase(it) : std::next(it);
+		}
+	}
+
 	unsigned int get_room_player_count(RoomID room_id)
 	{
 		int player_count = 0;
@@ -368,6 +382,8 @@ namespace Fortress::Network::Server
 		const RoomID room_id = recv_msg->room_id;
 		const eMapType map = recv_msg->map_type;
 		std::fill_n(hit_count[message->room_id], std::size(hit_count[message->room_id]), 0);
+		// flights of the previous game of the room.
+		clear_fired_projectiles(room_id);
 
 		GameInitMsg gi{};
 		uint8_t pos = 0;
@@ -445,7 +461,7 @@ namespace Fortress::Network::Server
 
 		const auto clients = get_room_client(room_id);
 		auto msg = create_network_message<GameStartMsg>(
-			eMessageType::GameStart, -1, room_id);
+			eMessageType::GameStart, -1, room_id, fixed_point_physics);
 
 		for(const auto& client : clients)
 		{
@@ -529,12 +545,97 @@ namespace Fortress::Network::Server
 		std::fill(std::begin(turn_end[room_id]), std::end(turn_end[room_id]), false);
 	}
 
+	void record_projectile_fire(const Message* message)
+	{
+		const auto* casted = reinterpret_cast<const ProjectileFireMsg*>(message);
+
+		fired_projectiles.insert_or_assign(
+			std::make_tuple(casted->room_id, casted->player_id, casted->prj_id),
+			ObjectBase::TrajectoryPredictor(
+				casted->position,
+				casted->velocity,
+				casted->speed,
+				{},
+				static_cast<float>(get_wind_acceleration(casted->room_id))));
+	}
+
+	// guided projectiles steer after the launch, so the ballistic flight does not apply to them.
+	bool is_guided_projectile(const RoomID room_id, const PlayerID player_id, const eProjectileType prj_type)
+	{
+		const auto it = client_list.find({room_id, player_id});
+
+		return it != client_list.end() &&
+			it->second.room_info.character == eCharacterType::MissileCharacter &&
+			prj_type == eProjectileType::Sub;
+	}
+
+	bool validate_projectile_hit(
+		const RoomID room_id, 
+		const PlayerID player_id, 
+		const unsigned int prj_id, 
+		const eProjectileType prj_type,
+		const Math::Vector2& position)
+	{
+		if(is_guided_projectile(room_id, player_id, prj_type))
+		{
+			return true;
+		}
+
+		const auto it = fired_projectiles.find(std::make_tuple(room_id, player_id, prj_id));
+
+		if(it == fired_projectiles.end())
+		{
+			return true;
+		}
+
+		float time = 0.0f;
+		const float distance = it->second.get_distance(position, time);
+		// hits are taken from the boundary of the projectile, and the steps of the integration drift
+		// from the curve more for the longer flight.
+		const float tolerance = Object::Property::projectile_hitbox_getter().magnitude() * (1.0f + time);
+
+		if(distance > tolerance)
+		{
+			std::cout << " Hit is off the trajectory by " << distance << " ";
+
+			// integration restarts the speed from the base speed when the headwind stops it, the curve does not.
+			if(it->second.is_reversed_before(time))
+			{
+				std::cout << "against the headwind, kept ";
+				return true;
+			}
+
+			return false;
+		}
+
+		return true;
+	}
+
+	void forget_projectile_fire(const Message* message)
+	{
+		const auto* casted = reinterpret_cast<const ProjectileHitMsg*>(message);
+
+		fired_projectiles.erase(std::make_tuple(casted->room_id, casted->player_id, casted->prj_id));
+	}
+
+	bool validate_projectile_hit(const Message* message)
+	{
+		const auto* casted = reinterpret_cast<const ProjectileHitMsg*>(message);
+
+		return validate_projectile_hit(
+			casted->room_id, casted->player_id, casted->prj_id, casted->prj_type, casted->position);
+	}
+
 	void calculate_damage_and_reply(Message* message, const sockaddr_in& client_info)
 	{
 		auto* casted = reinterpret_cast<DamageMsg*>(message);
 		auto& dd = double_damage_enabled[casted->room_id][casted->prj_owner_id];
 
-		const float damage = calculate_damage(
+		// the victim waits for the reply, so the damage of a hit off the trajectory is withheld instead.
+		const bool valid = validate_projectile_hit(
+			casted->room_id, casted->prj_owner_id, casted->prj_id, casted->prj_type, casted->prj_position);
+
+		const float damage = !valid ? 0.0f : calculate_damage(
 			casted->shooter_type,
 			casted->victim_type, 
 			casted->prj_type, 
@@ -631,6 +732,7 @@ namespace Fortress::Network::Server
 				break;
 			case eMessageType::ProjectileFire:
 				std::cout << "Message type : Projectile Fire";
+				record_projectile_fire(message);
 				broadcast<ProjectileFireMsg>(message);
 				break;
 			case eMessageType::ProjectileFlying:
@@ -639,8 +741,31 @@ namespace Fortress::Network::Server
 				break;
 			case eMessageType::ProjectileHit:
 				std::cout << "Message type : Projectile Hit ";
+				if(!validate_projectile_hit(message))
+				{
+					std::cout << "is dropped" << std::endl;
+					break;
+				}
+
+				forget_projectile_fire(message);
 				broadcast<ProjectileHitMsg>(message);
 				break;
+			case eMessageType::TerrainDigestReq:
+				std::cout << "Message type : Terrain Digest Request ";
+				broadcast<TerrainDigestReqMsg>(message);
+				break;
+			case eMessageType::TerrainDigest:
+				std::cout << "Message type : Terrain Digest ";
+				broadcast<TerrainDigestMsg>(message);
+				break;
+			case eMessageType::TerrainChunkReq:
+				std::cout << "Message type : Terrain Chunk Request ";
+				broadcast<TerrainChunkReqMsg>(message);
+				break;
+			case eMessageType::TerrainChunk:
+				std::cout << "Message type : Terrain Chunk ";
+				broadcast<TerrainChunkMsg>(message);
+				break;
 			case eMessageType::TurnEnd:
 				// @todo: check previous message.
 				std::cout << "Turn ended" << std::endl;
@@ -649,6 +774,7 @@ namespace Fortress::Network::Server
 				{
 					reset_wind(message->room_id);
 					clear_turn_done(message->room_id);
+					clear_fired_projectiles(message->room_id);
 					send_go(message, message->room_id);
 				}
 				break;
@@ -709,10 +835,19 @@ namespace Fortress::Network::Server
 	}
 }
 
-int main()
+int main(int argc, char* argv[])
 {
     std::cout << "Start server...\n";
 
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::string_view(argv[i]) == "--fixed-point")
+		{
+			Fortress::Network::Server::fixed_point_physics = true;
+			std::cout << "Fixed-point integration enabled\n";
+		}
+	}
+
 	std::thread receiving_task(
 		&Fortress::Network::Server::Socket::receiving_message, 
 		&Fortress::Network::Server::server_socket);